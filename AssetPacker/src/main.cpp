@@ -0,0 +1,40 @@
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "Lumina/Essence/Utils/AssetPack.hpp"
+#include "Lumina/Essence/Utils/FileIO.hpp"
+
+using namespace Lumina;
+
+// Usage: AssetPacker <pack> <root> <files...>
+// Files are stored relative to <root>, which should be the directory the pack ends up in.
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <pack> <root> <files...>\n";
+        return 1;
+    }
+
+    const std::filesystem::path packPath = argv[1];
+    const std::filesystem::path root = argv[2];
+
+    std::vector<Essence::AssetPack::File> files;
+    try {
+        for (int i = 3; i < argc; i++) {
+            const std::filesystem::path path = argv[i];
+            files.push_back({
+                std::filesystem::relative(path, root).generic_string(),
+                Essence::ReadBinaryFile(path.string()),
+            });
+        }
+
+        Essence::AssetPack::Write(packPath, files);
+    }
+    catch (std::exception const& e) {
+        std::cerr << "Failed to write " << packPath.string() << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "Packed " << files.size() << " files into " << packPath.string() << "\n";
+    return 0;
+}
\ No newline at end of file
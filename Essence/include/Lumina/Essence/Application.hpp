@@ -3,30 +3,80 @@
 #include "Lumina/Essence/Utils/NonCopyable.hpp"
 #include "Lumina/Essence/Vulkan.hpp"
 #include "Lumina/Essence/VulkanImage.hpp"
+#include "Lumina/Essence/VulkanBuffer.hpp"
+#include "Lumina/Essence/StagingRing.hpp"
+#include "Lumina/Essence/UploadManager.hpp"
 #include "Lumina/Essence/Window.hpp"
 #include "Lumina/Essence/DeletionQueue.hpp"
+#include "Lumina/Essence/CommandArena.hpp"
+#include "Lumina/Essence/RetirementQueue.hpp"
 #include "Lumina/Essence/DescriptorAllocator.hpp"
+#include "Lumina/Essence/BindlessHeap.hpp"
+#include "Lumina/Essence/GpuProfiler.hpp"
+#include "Lumina/Essence/DynamicResolution.hpp"
+#include "Lumina/Essence/ProgressiveAccumulation.hpp"
+#include "Lumina/Essence/DeepZoom.hpp"
+#include "Lumina/Essence/PipelineCache.hpp"
+#include "Lumina/Essence/PipelineCompiler.hpp"
+#include "Lumina/Essence/ComputeVariantCache.hpp"
+#include "Lumina/Essence/ShaderHotReload.hpp"
+#include "Lumina/Essence/WorkgroupTuner.hpp"
+#include "Lumina/Essence/RenderGraph.hpp"
+#include "Lumina/Essence/Utils/JobSystem.hpp"
+#include "Lumina/Essence/Utils/TripleBuffer.hpp"
 #include "Lumina/Essence/Utils/Packed.hpp"
+#include "Lumina/Essence/Utils/Platform.hpp"
 
 #include <glm/glm.hpp>
 
 #include <vector>
 #include <string>
 #include <array>
+#include <optional>
+#include <functional>
+#include <span>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 namespace Lumina::Essence {
 
 LUMINA_PACKED(struct ComputePushConstants {
+    glm::vec2 renderSize = {};
+    glm::vec2 referenceOffset = {};
+    uint32_t accumulationImageIndex = BindlessHeap::invalidHandle;
+    uint32_t sampleIndex = 0;
+    uint32_t numSamples = 0;
+    uint32_t previewScale = 1;
+
+    float pixelScale = 1;
+    uint32_t orbitBufferIndex = BindlessHeap::invalidHandle;
+    uint32_t referenceLength = 0;
+    uint32_t criticalOffset = 0;
+    uint32_t criticalLength = 0;
+    uint32_t maxIterations = 0;
+});
+
+LUMINA_PACKED(struct ResolvePushConstants {
     glm::vec4 color1 = {1, 0, 0, 1};
-    glm::vec2 samplePoint = {};
+    glm::vec2 renderSize = {};
+    uint32_t accumulationImageIndex = BindlessHeap::invalidHandle;
+    uint32_t drawImageIndex = BindlessHeap::invalidHandle;
 });
 
+enum class DisplayMode {
+    Windowed,
+    Headless, // no window and no swapchain, frames end at the draw image
+};
+
 class Application : NonCopyable {
 public:
-    Application(glm::ivec2 windowSize, std::string const& windowTitle);
+    Application(glm::ivec2 windowSize, std::string const& windowTitle, DisplayMode displayMode = DisplayMode::Windowed);
     virtual ~Application();
     virtual void Initialize();
 
+    // Once per frame with the frame time, or at a fixed rate on its own thread if isTickThreadEnabled. Advances
+    // the Julia animation, so overrides have to call it.
     virtual void Tick(float dt);
 
     virtual void PreRender(float dt);
@@ -38,26 +88,44 @@ public:
     void Run();
     void Exit();
 
+    inline bool IsHeadless() const {
+        return !window.has_value();
+    }
+
     const std::string name;
 
 protected:
     struct FrameData {
-        vk::CommandPool commandPool;
-        vk::CommandBuffer mainCommandBuffer;
+        CommandArena commands;               // reset once the frame retired
+        vk::CommandBuffer mainCommandBuffer; // allocated from `commands` every frame
 
         vk::Semaphore renderSemaphore, swapchainSemaphore;
-        vk::Fence renderFence;
 
-        DeletionQueue deletionQueue;
+        DescriptorAllocator frameDescriptors; // reset once the frame retired
+
+        GpuProfiler::FrameQueries timestamps;
     };
 
     vk::Fence immediateFence;
     vk::CommandBuffer immediateCommandBuffer;
     vk::CommandPool immediateCommandPool;
 
-    std::array<FrameData, 2> frames;
+    // must be set before Initialize(), between 1 and maxFramesInFlight
+    uint32_t framesInFlight = 2;
+    static constexpr uint32_t maxFramesInFlight = 4;
+
+    std::vector<FrameData> frames;
 
-    Window window;
+    // Frame N signals the value N + 1 once the GPU finished it. Anything used by a frame can be
+    // retired once GetCompletedFrameValue() reached that frame's value.
+    vk::Semaphore frameTimeline;
+
+    inline uint64_t GetFrameTimelineValue() const {
+        return currentFrame + 1;
+    }
+    uint64_t GetCompletedFrameValue() const;
+
+    std::optional<Window> window;
     uint32_t currentImageIndex = 0;
 
     vk::Instance instance;
@@ -75,20 +143,151 @@ protected:
 
     DeletionQueue mainDeletionQueue;
 
-    VmaAllocator allocator;
+    // Objects replaced at runtime that earlier frames may still use, retire them with GetFrameTimelineValue().
+    RetirementQueue retirementQueue;
 
-    VulkanImage drawImage;
-    vk::Extent2D drawExtent;
+    GpuProfiler gpuProfiler;
+    DynamicResolution dynamicResolution;
+
+    // Uploads recorded through this before Render() are visible to everything recorded in Render().
+    StagingRing stagingRing;
+    static constexpr vk::DeviceSize stagingBytesPerFrame = 16 * 1024 * 1024;
 
-    DescriptorAllocator globalDescriptorAllocator;
-    vk::DescriptorSet drawImageDescriptors;
-    vk::DescriptorSetLayout drawImageDescriptorLayout;
+    // Uploads that don't have to land this frame, e.g. streamed assets. They run on the transfer queue and
+    // are waited for with WaitForUpload() by the first frame that uses them.
+    UploadManager uploadManager;
 
-    vk::Pipeline gradientPipeline;
-    vk::PipelineLayout gradientPipelineLayout;
+    // Makes the current frame wait on the GPU for `token` and take ownership of its resources.
+    void WaitForUpload(UploadToken token);
 
-    vk::Pipeline trianglePipeline;
-    vk::PipelineLayout trianglePipelineLayout;
+    // Only valid between PreRender() and PostRender().
+    vk::CommandBuffer GetCurrentCommandBuffer();
+
+    // Called with a command buffer of its own and the index of the batch.
+    using BatchFunction = std::function<void(vk::CommandBuffer cmd, uint32_t batch)>;
+
+    // Records `numBatches` draw batches in parallel on the job system, each into its own secondary command
+    // buffer, and executes them on `cmd` in batch order. `cmd` has to be inside beginRendering() with
+    // eContentsSecondaryCommandBuffers and attachments of these formats. Batches start with only the bindless
+    // heap bound, they have to bind their pipeline and set the viewport and scissor themselves. Profiler zones
+    // can't be opened inside a batch, put one around the whole call instead.
+    void RecordRenderingBatches(
+        vk::CommandBuffer cmd,
+        std::span<const vk::Format> colorFormats,
+        vk::Format depthFormat,
+        uint32_t numBatches,
+        BatchFunction const& record
+    );
+    // Like RecordRenderingBatches() for dispatches, `cmd` has to be outside of rendering.
+    void RecordComputeBatches(vk::CommandBuffer cmd, uint32_t numBatches, BatchFunction const& record);
+
+    // Index of the calling thread in the command arenas: 0 for the thread running the frame, 1 for the tick
+    // thread, which can pick up batches while it waits for its own jobs, and 2 and up for the workers of the job system.
+    uint32_t GetRecordingThreadIndex() const;
+
+    VmaAllocator allocator;
+
+    VulkanImage drawImage;
+    vk::Extent2D drawExtent; // part of the draw image that is rendered to this frame
+
+    // Rebuilt every frame. Passes added in Render() are recorded at the end of PostRender(), after the
+    // blit and ImGui passes, so they must not capture anything by reference that dies before that.
+    RenderGraph renderGraph;
+    RenderGraph::ResourceId drawImageResource = 0;
+
+    // Julia set samples summed up over frames, rgb is the sum and a the number of samples. It has the size
+    // of the draw image and is resolved into it every frame.
+    VulkanImage accumulationImage;
+    uint32_t accumulationImageIndex = BindlessHeap::invalidHandle;
+    ProgressiveAccumulation progressiveAccumulation;
+    DeepZoom deepZoom;
+    ComputePushConstants lastJuliaInputs; // restarts the accumulation when they change
+    uint64_t lastDeepZoomVersion = 0;
+    std::atomic<bool> isJuliaAnimated = true; // read by Tick(), which may run on the tick thread
+    float juliaTime = 0;
+    // With the tick thread Tick() owns the animation and Render() interpolates juliaTime from the last state.
+    struct JuliaTickState {
+        uint64_t tickIndex = 0;
+        float previousTime = 0;
+        float time = 0;
+    };
+    TripleBuffer<JuliaTickState> juliaTickStates;
+    float tickJuliaTime = 0; // tick thread only
+    std::optional<glm::dvec2> pinnedJuliaParameter; // replaces the animated c when set
+    glm::vec4 juliaColor = {1, 0, 0, 1}; // tint applied by the resolve, its hue turns every frame
+
+    // Descriptor sets allocated from here are only valid until the current frame retires.
+    DescriptorAllocator& GetFrameDescriptorAllocator();
+
+    // bound for compute and graphics at the start of every frame
+    BindlessHeap bindlessHeap;
+    uint32_t drawImageIndex = BindlessHeap::invalidHandle;
+
+    // must be set before Initialize()
+    std::string pipelineCachePath = "pipeline_cache.bin";
+    PipelineCache pipelineCache;
+
+    // Must be set before Initialize(). Shaders are loaded from loose files if there is no pack.
+    std::string assetPackPath = "resources/shaders.lpk";
+    AssetPack assetPack;
+
+    // Runs pipeline compilation, shader recompilation and batch recording. Tick() can fan out over all cores
+    // with ParallelFor(), or with Run() and counters for jobs that depend on each other.
+    JobSystem jobSystem;
+    // Jobs started in Tick() with this counter are waited for before the frame is rendered, or before the
+    // next tick on the tick thread. The waiting thread helps with them in the meantime.
+    JobCounter tickJobs;
+    PipelineCompiler pipelineCompiler;
+
+    // specialized for their workgroup shape
+    ComputeVariantCache gradientVariants;
+    ComputeVariantCache resolveVariants;
+    PipelineHandle trianglePipeline;
+    PipelineBuilder trianglePipelineBuilder;
+
+    // Must be set before Initialize(). Edited shader sources are recompiled in the background and their
+    // pipelines are swapped in at the start of a frame once they are built.
+    bool isShaderHotReloadEnabled = BuildMode::Current == BuildMode::Debug;
+    std::string shaderSourceDirectory = "resources/shaders";
+    ShaderHotReload shaderHotReload;
+    PipelineHandle reloadedTrianglePipeline;
+
+    // Must be set before Initialize(). Shapes found on earlier runs are reused without benchmarking.
+    bool isWorkgroupTuningEnabled = true;
+    std::string workgroupTuningPath = "workgroup_tuning.txt";
+    WorkgroupTuner workgroupTuner;
+    WorkgroupTuner::Shape gradientShape;
+    WorkgroupTuner::Shape resolveShape;
+
+    // Parts of the default frame, e.g. to measure them on their own. Without the imgui pass the windows
+    // are still built, just not drawn.
+    bool isJuliaEnabled = true;
+    bool isTriangleEnabled = true;
+    bool isImGuiEnabled = true;
+    // Above 1 the Julia dispatch is split into this many bands of rows recorded in parallel with
+    // RecordComputeBatches().
+    uint32_t numJuliaBatches = 1;
+
+    // Must be set before Initialize(). Runs Tick() on a thread of its own `tickRate` times per second with a fixed
+    // dt, so the simulation is deterministic and rendering never waits for it. Tick() then must not touch
+    // anything the frame uses, it publishes what rendering needs instead, e.g. the last two states in a
+    // TripleBuffer together with GetTickIndex(), and Render() blends them with GetTickAlpha().
+    bool isTickThreadEnabled = false;
+    double tickRate = 60;
+
+    // On the tick thread the index of the running tick, elsewhere the number of finished ticks.
+    inline uint64_t GetTickIndex() const {
+        return numTicks.load(std::memory_order_acquire);
+    }
+    // How far the frame is between the state before and after tick `tickIndex`, in [0, 1]. This is a tick
+    // behind the simulation, so it only reaches 1 if the next tick is late.
+    float GetTickAlpha(uint64_t tickIndex) const;
+
+    struct StartupPhase {
+        std::string name;
+        double durationMs;
+    };
+    std::vector<StartupPhase> startupPhases; // filled by Initialize()
 
     const std::string windowTitle;
     const glm::uvec2 windowSize;
@@ -100,21 +299,58 @@ private:
     void InitSwapchain();
     void InitCommands();
     void InitSyncObjects();
+    void InitProfiler();
+    void InitUploads();
     void InitDescriptors();
     void InitPipelines();
     void InitImgui();
 
     void InitBackgroundPipelines();
     void InitTrianglePipeline();
+    void InitWorkgroupTuning();
+    void InitShaderHotReload();
+
+    void SwapReloadedPipelines();
+
+    void StartTickThread();
+    void StopTickThread();
+    void TickLoop();
+
+    // Dispatches the rows of workgroups of `batch` out of `numBatches`, all of them by default. `pipeline` is the
+    // gradient variant of `shape`, looked up by the caller since batches record on the workers.
+    void RecordJulia(
+        vk::CommandBuffer cmd,
+        vk::Pipeline pipeline,
+        ComputePushConstants const& pushConstants,
+        WorkgroupTuner::Shape shape,
+        uint32_t batch = 0,
+        uint32_t numBatches = 1
+    );
+    void RecordJuliaResolve(vk::CommandBuffer cmd, ResolvePushConstants const& pushConstants, WorkgroupTuner::Shape shape);
     void CreateSwapchain(glm::ivec2 size);
+    void DestroySwapchain();
+    bool RecreateSwapchain();
+    void AcquireSwapchainImage();
+    void CreateDrawImage(vk::Extent2D extent);
+    void GrowDrawImage(vk::Extent2D minExtent);
+    void WaitForFrameValue(uint64_t value);
 
-    void RenderImGui(vk::CommandBuffer cmd, vk::ImageView targetView);
+    void RenderImGui(vk::CommandBuffer cmd, vk::ImageView targetView, vk::Extent2D targetExtent);
 
     inline FrameData& GetCurrentFrame() {
         return frames.at(currentFrame % frames.size());
     }
 
+    void RecordBatches(
+        vk::CommandBuffer cmd,
+        vk::CommandBufferBeginInfo const& beginInfo,
+        vk::PipelineBindPoint bindPoint,
+        uint32_t numBatches,
+        BatchFunction const& record
+    );
+
     void SubmitImmediately(std::function<void(vk::CommandBuffer)>&& func);
+    void SubmitFrame(vk::CommandBuffer cmd);
 
     // Feel free to copy-paste it into your own code, change it as needed, then call `set_debug_callback()` to use that instead
     static inline VKAPI_ATTR VkBool32 VKAPI_CALL VulkanDebugCallback(
@@ -124,17 +360,29 @@ private:
         void* userData
     );
 
-    bool isRunning = false;
+    std::atomic<bool> isRunning = false; // Exit() may be called from the tick thread
     bool isInitialized = false;
     bool isRenderingEnabled = true;
+    bool isSwapchainOutdated = false;
 
-    uint32_t currentFrame = 0;
+    uint64_t currentFrame = 0;
     uint32_t currentSwapchainImageIndex = 0;
 
     vk::Queue graphicsQueue;
     uint32_t graphicsQueueFamily;
+    vk::Queue transferQueue; // the graphics queue if there is no separate transfer queue
+    uint32_t transferQueueFamily;
+
+    std::vector<vk::SemaphoreSubmitInfo> pendingUploadWaits; // waited on by the next frame submission
+
+    std::thread tickThread;
+    std::atomic<bool> isTickThreadRunning = false;
+    std::atomic<uint64_t> numTicks = 0;
+    // When the tick thread started, moved forward by the ticks skipped because the simulation couldn't keep up.
+    std::atomic<std::chrono::steady_clock::rep> tickEpoch = 0;
 
     friend class VulkanImage;
+    friend class VulkanBuffer;
 };
 
 }
\ No newline at end of file
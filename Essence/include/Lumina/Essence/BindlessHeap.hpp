@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace Lumina::Essence {
+
+class VulkanImage;
+
+// One big update-after-bind descriptor set holding every resource. Resources are referred to by a stable
+// index, so the set is bound once per frame and shaders pick their resources through push constants.
+class BindlessHeap : NonCopyable {
+public:
+    enum class Binding : uint32_t {
+        StorageImage = 0,
+        SampledImage = 1,
+        Sampler = 2,
+        StorageBuffer = 3,
+    };
+    static constexpr uint32_t numBindings = 4;
+    static constexpr uint32_t invalidHandle = UINT32_MAX;
+    static constexpr uint32_t pushConstantSize = 128; // guaranteed minimum of maxPushConstantsSize
+
+    void Initialize(vk::PhysicalDevice physicalDevice, vk::Device device);
+    void Destroy();
+
+    // Storage images have to be in the general layout when a shader accesses them.
+    uint32_t RegisterStorageImage(VulkanImage const& image);
+    uint32_t RegisterSampledImage(VulkanImage const& image);
+    uint32_t RegisterSampler(vk::Sampler sampler);
+    uint32_t RegisterStorageBuffer(vk::Buffer buffer, vk::DeviceSize offset = 0, vk::DeviceSize range = vk::WholeSize);
+
+    // The slot is handed out again once the frame timeline reached `retireValue`.
+    void Release(Binding binding, uint32_t handle, uint64_t retireValue);
+    void CollectRetired(uint64_t completedValue);
+
+    void Bind(vk::CommandBuffer cmd, vk::PipelineBindPoint bindPoint) const;
+
+    inline vk::DescriptorSetLayout GetLayout() const {
+        return layout;
+    }
+    // Shared by every pipeline using the heap: set 0 is the heap and all stages get `pushConstantSize` bytes.
+    inline vk::PipelineLayout GetPipelineLayout() const {
+        return pipelineLayout;
+    }
+
+private:
+    class SlotAllocator {
+    public:
+        explicit SlotAllocator(uint32_t capacity = 0);
+
+        uint32_t Allocate();
+        void Release(uint32_t slot, uint64_t retireValue);
+        void CollectRetired(uint64_t completedValue);
+
+    private:
+        uint32_t capacity;
+        uint32_t nextUnused = 0;
+        std::vector<uint32_t> freeSlots;
+        std::deque<std::pair<uint64_t, uint32_t>> retiredSlots; // ordered by retire value
+    };
+
+    void Write(Binding binding, uint32_t slot, vk::DescriptorImageInfo const* imageInfo, vk::DescriptorBufferInfo const* bufferInfo);
+
+    static constexpr std::array<vk::DescriptorType, numBindings> descriptorTypes = {
+        vk::DescriptorType::eStorageImage,
+        vk::DescriptorType::eSampledImage,
+        vk::DescriptorType::eSampler,
+        vk::DescriptorType::eStorageBuffer,
+    };
+
+    vk::Device device;
+    vk::DescriptorPool pool;
+    vk::DescriptorSetLayout layout;
+    vk::DescriptorSet set;
+    vk::PipelineLayout pipelineLayout;
+
+    std::array<SlotAllocator, numBindings> slots;
+};
+
+}
\ No newline at end of file
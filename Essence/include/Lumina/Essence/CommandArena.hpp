@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// The command buffers of one frame in flight. A pool may only be used by one thread at a time, so every
+// recording thread gets its own. Reset() recycles all pools at once, buffers are handed out again instead
+// of being freed, so steady state frames never allocate command buffers.
+class CommandArena : NonCopyable {
+public:
+    // One pool per thread that may record, the owner decides which thread uses which index.
+    void Initialize(vk::Device device, uint32_t queueFamily, uint32_t numThreads);
+    void Destroy();
+
+    // Every buffer handed out since the last reset must have finished executing on the GPU.
+    void Reset();
+
+    // Only ever call these with the index of the calling thread. The buffers are valid until the next Reset().
+    vk::CommandBuffer AllocatePrimary(uint32_t threadIndex);
+    vk::CommandBuffer AllocateSecondary(uint32_t threadIndex);
+
+    inline uint32_t GetThreadCount() const {
+        return static_cast<uint32_t>(threads.size());
+    }
+
+private:
+    // padded so threads recording next to each other don't share cache lines
+    struct alignas(64) ThreadCommands {
+        vk::CommandPool pool;
+        std::vector<vk::CommandBuffer> primaries;
+        std::vector<vk::CommandBuffer> secondaries;
+        uint32_t numUsedPrimaries = 0;
+        uint32_t numUsedSecondaries = 0;
+    };
+
+    vk::CommandBuffer Allocate(ThreadCommands& thread, vk::CommandBufferLevel level);
+
+    vk::Device device;
+    std::vector<ThreadCommands> threads;
+};
+
+}
\ No newline at end of file
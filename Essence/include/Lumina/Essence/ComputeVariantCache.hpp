@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Lumina/Essence/PipelineCompiler.hpp"
+#include "Lumina/Essence/RetirementQueue.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// All specialized pipelines of one compute shader. Variants compile on first use and stay around until
+// Destroy(), so switching between them is free after that.
+class ComputeVariantCache : NonCopyable {
+public:
+    void Initialize(vk::Device device, PipelineCompiler& compiler, std::string const& shaderPath, vk::PipelineLayout layout);
+    void Destroy();
+
+    PipelineHandle Get(std::vector<SpecializationConstant> constants);
+
+    // Recompiles every variant from the current SPIR-V. Get() keeps returning the old pipelines until
+    // SwapReloaded() found all of them compiled.
+    void Reload();
+    // Replaces the variants once the whole reload is done and retires the old pipelines with `retireValue`,
+    // the value of the last frame that may use them. Variants that failed to compile keep their old pipeline.
+    // Also destroys the pipelines of superseded reloads that finished compiling.
+    bool SwapReloaded(RetirementQueue& retirementQueue, uint64_t retireValue);
+
+    inline std::string const& GetShaderPath() const {
+        return shaderPath;
+    }
+
+    inline size_t GetNumVariants() const {
+        return variants.size();
+    }
+
+private:
+    void DestroyFinishedSuperseded();
+
+    vk::Device device;
+    PipelineCompiler* compiler = nullptr;
+    std::string shaderPath;
+    vk::PipelineLayout layout;
+
+    std::map<std::vector<SpecializationConstant>, PipelineHandle> variants; // keyed by constants sorted by id
+    std::map<std::vector<SpecializationConstant>, PipelineHandle> reloadedVariants;
+    std::vector<PipelineHandle> supersededVariants; // of reloads replaced while still compiling, never used
+};
+
+}
\ No newline at end of file
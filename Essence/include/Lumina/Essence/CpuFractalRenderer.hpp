@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Lumina/Essence/StagingRing.hpp"
+#include "Lumina/Essence/VulkanImage.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+#include "Lumina/Essence/Utils/JobSystem.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// Renders the same Julia set as gradient.comp and julia_resolve.comp on the CPU, for machines without a
+// Vulkan device, as a reference to validate GPU readbacks against and as a throughput baseline. Each
+// pixel is iterated directly in float, which matches the perturbation of the shader as long as the view
+// isn't zoomed in below float precision.
+class CpuFractalRenderer : NonCopyable {
+public:
+    enum class InstructionSet {
+        Scalar,
+        Sse2, // 4 lanes
+        Avx2, // 8 lanes
+    };
+
+    struct Parameters {
+        glm::uvec2 size;
+        glm::dvec2 center = {}; // complex coordinates of the image center
+        double pixelScale;      // complex units per pixel
+        glm::dvec2 c;           // Julia parameter
+        uint32_t maxIterations;
+        uint32_t numSamples = 1; // R2 jittered samples per pixel, like an accumulation of the same length
+        glm::vec4 color1 = {1, 0, 0, 1};
+    };
+
+    struct Difference {
+        float maxError = 0;
+        uint32_t numMismatches = 0; // pixels with a channel further off than the tolerance
+    };
+
+    // Uses the widest instruction set the CPU supports unless told otherwise.
+    explicit CpuFractalRenderer(InstructionSet instructionSet = DetectInstructionSet());
+
+    // Renders into RGBA16F texels, the format of drawImage, tightly packed row by row.
+    void Render(Parameters const& parameters, JobSystem& jobSystem);
+
+    // Copies the last rendered image into the top left corner of `image`, which ends up in
+    // eTransferDstOptimal. Returns false if the staging ring is full.
+    bool Upload(vk::CommandBuffer cmd, StagingRing& stagingRing, VulkanImage& image) const;
+
+    // Compares two RGBA16F images of the same size channel by channel. NaN in both images counts as equal.
+    static Difference Compare(std::span<const uint16_t> a, std::span<const uint16_t> b, float tolerance);
+
+    static InstructionSet DetectInstructionSet();
+
+    inline std::span<const uint16_t> GetPixels() const {
+        return pixels;
+    }
+
+    inline glm::uvec2 GetSize() const {
+        return size;
+    }
+
+    inline InstructionSet GetInstructionSet() const {
+        return instructionSet;
+    }
+
+    static constexpr uint32_t tileSize = 64;
+
+private:
+    InstructionSet instructionSet;
+
+    std::vector<uint16_t> pixels; // 4 halfs per pixel
+    glm::uvec2 size = {};
+};
+
+}
\ No newline at end of file
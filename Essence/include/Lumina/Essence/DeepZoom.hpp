@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Lumina/Essence/VulkanBuffer.hpp"
+#include "Lumina/Essence/BindlessHeap.hpp"
+#include "Lumina/Essence/Utils/DoubleDouble.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+#include "Lumina/Essence/Utils/JobSystem.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// View of the Julia set at zoom depths far below float precision. The CPU iterates a reference orbit in
+// double-double precision and the shader only iterates each pixel's float offset to it (perturbation).
+// Pixels whose offset grows too large relative to the reference continue on the critical orbit that
+// starts at 0 (rebasing), which is stored right after the reference orbit.
+class DeepZoom : NonCopyable {
+public:
+    struct Settings {
+        uint32_t baseIterations = 100;
+        uint32_t iterationsPerOctave = 20; // deeper views show detail at higher iteration counts
+        uint32_t numCandidates = 5;        // reference points tried per orbit, the longest lived one wins
+
+        bool operator==(Settings const& other) const = default;
+    };
+
+    // Everything the shader needs besides the orbits themselves.
+    struct Parameters {
+        float pixelScale;          // complex units per pixel
+        glm::vec2 referenceOffset; // start of the reference orbit relative to the view center
+        uint32_t orbitBufferIndex;
+        uint32_t referenceLength;
+        uint32_t criticalOffset;
+        uint32_t criticalLength;
+        uint32_t maxIterations;
+    };
+
+    void Initialize(Application& app, BindlessHeap& heap, uint32_t numFrames);
+    void Destroy();
+
+    void SetJuliaParameter(glm::dvec2 c);
+    // Scales the zoom by `factor` and keeps the point at `offset` (complex units from the center) in place.
+    void ZoomAt(glm::dvec2 offset, double factor);
+
+    // Recomputes the orbits if the view changed and makes sure the region of `frameIndex` holds them.
+    // The region must not be in use by the GPU anymore.
+    Parameters Update(uint32_t frameIndex, glm::vec2 renderSize, JobSystem& jobSystem);
+
+    double GetPixelScale(glm::vec2 renderSize) const;
+    uint32_t GetMaxIterations() const;
+
+    // rounded to double, e.g. for a reference render that doesn't zoom as deep
+    inline glm::dvec2 GetCenter() const {
+        return {static_cast<double>(centerX), static_cast<double>(centerY)};
+    }
+    inline glm::dvec2 GetJuliaParameter() const {
+        return c;
+    }
+
+    // changes whenever the rendered fractal does
+    inline uint64_t GetVersion() const {
+        return version;
+    }
+
+    void DrawImGui();
+
+    Settings settings;
+
+    static constexpr uint32_t maxOrbitLength = 16384;
+    static constexpr double maxZoom = 1e28; // float offsets and double-double centers both run out around here
+
+private:
+    struct Orbit {
+        std::vector<glm::vec2> points; // until the orbit escaped or hit the iteration limit
+        glm::dvec2 start;              // relative to the view center
+    };
+
+    struct Region {
+        uint32_t heapIndex;
+        uint64_t version = 0;
+    };
+
+    static Orbit ComputeOrbit(DoubleDouble x, DoubleDouble y, glm::dvec2 c, uint32_t maxIterations);
+    void ComputeOrbits(glm::vec2 renderSize, JobSystem& jobSystem);
+
+    DoubleDouble centerX = 0;
+    DoubleDouble centerY = 0;
+    double zoom = 1;
+    glm::dvec2 c = {};
+
+    uint64_t version = 1;
+    uint64_t orbitVersion = 0;
+    Settings lastSettings;
+
+    std::vector<glm::vec2> orbitData; // reference orbit followed by the critical orbit
+    glm::vec2 referenceOffset = {};
+    uint32_t referenceLength = 0;
+    uint32_t criticalLength = 0;
+
+    VulkanBuffer buffer;
+    std::vector<Region> regions;
+    static constexpr vk::DeviceSize regionSize = maxOrbitLength * 2 * sizeof(glm::vec2);
+};
+
+}
\ No newline at end of file
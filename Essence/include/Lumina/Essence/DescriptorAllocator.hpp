@@ -2,8 +2,13 @@
 
 #include "Lumina/Essence/Vulkan.hpp"
 
+#include <span>
+#include <vector>
+
 namespace Lumina::Essence {
 
+// Hands out descriptor sets from a chain of pools. When a pool runs out a bigger one is created, Reset()
+// recycles all of them at once so steady state allocations never create or free pools.
 class DescriptorAllocator {
 public:
     struct PoolSizeRatio {
@@ -11,45 +16,25 @@ public:
         float ratio;
     };
 
-    void Initialize(vk::Device device, uint32_t maxSets, std::span<PoolSizeRatio> poolRatios) {
-        this->device = device;
-
-        std::vector<vk::DescriptorPoolSize> poolSizes;
-        for (auto ratio : poolRatios) {
-            poolSizes.emplace_back(ratio.type, uint32_t(ratio.ratio * maxSets));
-        }
-
-        vk::DescriptorPoolCreateInfo poolInfo = {
-            {},
-            maxSets,
-            poolSizes,
-        };
-
-        pool = device.createDescriptorPool(poolInfo);
-    }
-    void Destroy() {
-        if (device) {
-            device.destroyDescriptorPool(pool);
-            device = nullptr;
-        }
-    }
-
-    void Reset() {
-        device.resetDescriptorPool(pool, {});
-    }
-
-    vk::DescriptorSet Allocate(vk::DescriptorSetLayout layout) {
-        vk::DescriptorSetAllocateInfo info = {
-            pool,
-            1,
-            &layout,
-        };
-
-        return device.allocateDescriptorSets(info)[0];
-    }
+    void Initialize(vk::Device device, uint32_t initialSets, std::span<const PoolSizeRatio> poolRatios);
+    void Destroy();
+
+    void Reset();
+
+    vk::DescriptorSet Allocate(vk::DescriptorSetLayout layout, void const* pNext = nullptr);
+
+    static constexpr float growthFactor = 1.5f;
+    static constexpr uint32_t maxSetsPerPool = 4096;
 
 private:
-    vk::DescriptorPool pool;
+    vk::DescriptorPool GetPool();
+    vk::DescriptorPool CreatePool(uint32_t numSets);
+
+    std::vector<PoolSizeRatio> ratios;
+    std::vector<vk::DescriptorPool> fullPools;
+    std::vector<vk::DescriptorPool> readyPools;
+    uint32_t setsPerPool = 0;
+
     vk::Device device;
 };
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+
+#include <cstdint>
+
+namespace Lumina::Essence {
+
+// Scales the render extent so the measured GPU frame time stays close to a target.
+class DynamicResolution {
+public:
+    struct Settings {
+        bool enabled = false;
+        float targetFrameTimeMs = 16.6f;
+        float minScale = 0.5f;
+        float maxScale = 1.0f;
+        float hysteresis = 0.1f;     // relative distance to the target in which the scale is left alone
+        uint32_t settleFrames = 8;   // frames averaged between two adjustments
+        float maxStepUp = 1.05f;     // growing is slower than shrinking so a spike doesn't oscillate
+    };
+
+    void Update(float gpuFrameTimeMs);
+    vk::Extent2D GetRenderExtent(vk::Extent2D maxExtent) const;
+
+    inline float GetScale() const {
+        return settings.enabled ? scale : 1.0f;
+    }
+
+    void DrawImGui();
+
+    Settings settings;
+
+private:
+    float scale = 1.0f;
+
+    float accumulatedFrameTimeMs = 0;
+    uint32_t numSamples = 0;
+};
+
+}
\ No newline at end of file
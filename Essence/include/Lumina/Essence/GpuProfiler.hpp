@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+
+namespace Lumina::Essence {
+
+class GpuProfiler : NonCopyable {
+public:
+    // Timestamp queries of a single frame. Each frame in flight owns one of these, so when a frame starts
+    // the queries it holds were written by the last frame using the same slot and are already complete.
+    struct FrameQueries {
+        vk::QueryPool queryPool;
+        std::vector<uint32_t> zoneIds; // zone id of every begin/end query pair
+    };
+
+    class Zone : NonCopyable {
+    public:
+        Zone(GpuProfiler* profiler, vk::CommandBuffer cmd, uint32_t queryPair);
+        ~Zone();
+
+    private:
+        GpuProfiler* profiler;
+        vk::CommandBuffer cmd;
+        uint32_t queryPair;
+    };
+
+    struct Statistics {
+        std::string name;
+        float lastMs = 0;
+        float minMs = 0;
+        float avgMs = 0;
+        float p99Ms = 0;
+        uint32_t numSamples = 0;
+    };
+
+    void Initialize(vk::PhysicalDevice physicalDevice, vk::Device device, uint32_t queueFamily);
+    void CreateFrameQueries(FrameQueries& frame);
+    void DestroyFrameQueries(FrameQueries& frame);
+
+    // Reads back the results of the frame that used these queries last and resets them for this frame.
+    void BeginFrame(vk::CommandBuffer cmd, FrameQueries& frame);
+
+    [[nodiscard]]
+    Zone Scope(vk::CommandBuffer cmd, std::string const& name);
+
+    std::vector<Statistics> GetStatistics() const;
+    inline float GetLastFrameTime() const {
+        return lastFrameMs;
+    }
+
+    void DrawImGui();
+    void WriteCsv(std::filesystem::path const& path) const;
+    void WriteJson(std::filesystem::path const& path) const;
+
+    static constexpr uint32_t maxZonesPerFrame = 64;
+    static constexpr uint32_t historySize = 240;
+
+private:
+    struct ZoneHistory {
+        std::string name;
+        std::vector<float> samples;
+        uint32_t nextSample = 0;
+        uint32_t numSamples = 0;
+        float frameAccumulator = 0;
+        bool seenThisFrame = false;
+    };
+
+    void EndZone(vk::CommandBuffer cmd, uint32_t queryPair);
+    void CollectResults(FrameQueries& frame);
+    uint32_t GetZoneId(std::string const& name);
+    static void PushSample(ZoneHistory& zone, float sample);
+    static Statistics ComputeStatistics(ZoneHistory const& zone);
+
+    vk::Device device;
+    bool enabled = false;
+    float timestampPeriod = 1;  // nanoseconds per tick
+    uint64_t timestampMask = 0; // only timestampValidBits are meaningful
+
+    FrameQueries* currentFrame = nullptr;
+
+    std::unordered_map<std::string, uint32_t> zoneIds;
+    std::vector<ZoneHistory> zones;
+    ZoneHistory frameHistory = {"frame"};
+    float lastFrameMs = 0;
+
+    std::vector<uint64_t> queryResults;
+};
+
+}
\ No newline at end of file
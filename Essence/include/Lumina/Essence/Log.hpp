@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Lumina/Essence/Utils/Platform.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace Lumina::Essence {
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error,
+};
+
+enum class LogCategory : uint8_t {
+    General,
+    Vulkan,    // device setup and validation messages
+    Pipelines, // compilation, caches and shader reloads
+    Resources, // creation and destruction of GPU objects
+    Profiling,
+    Count,
+};
+
+// Statements below this level are compiled out, define it to override the default.
+#ifndef LUMINA_LOG_LEVEL
+    #if defined(LUMINA_DEBUG)
+        #define LUMINA_LOG_LEVEL 1 // LogLevel::Debug
+    #else
+        #define LUMINA_LOG_LEVEL 2 // LogLevel::Info
+    #endif
+#endif
+
+// Logging that never waits on I/O or other threads. Every thread formats its messages into a ring buffer
+// of its own and a background thread adds the time, level and category and writes them out. If a ring is
+// full the message is dropped and the drop is reported later. Messages of one thread stay in order.
+class Log {
+public:
+    // Writes to the file at `path` instead of the console from now on.
+    static void SetOutputFile(std::filesystem::path const& path);
+    // Drops messages of `category` below `level` at runtime, on top of LUMINA_LOG_LEVEL.
+    static void SetLevel(LogCategory category, LogLevel level);
+    // Writes everything logged so far before returning.
+    static void Flush();
+
+    static bool IsEnabled(LogLevel level, LogCategory category);
+
+    template <typename... Args>
+    static void Write(LogLevel level, LogCategory category, std::format_string<Args...> format, Args&&... args) {
+        if (!IsEnabled(level, category)) {
+            return;
+        }
+
+        std::span<char> scratch = GetScratchBuffer();
+        auto result = std::format_to_n(scratch.data(), static_cast<std::ptrdiff_t>(scratch.size()), format, std::forward<Args>(args)...);
+        const auto length = std::min(static_cast<size_t>(result.size), scratch.size());
+        Push(level, category, {scratch.data(), length}, length < static_cast<size_t>(result.size));
+    }
+
+    // longer messages are cut off
+    static constexpr size_t maxMessageLength = 4096;
+
+private:
+    // thread local, so formatting doesn't allocate
+    static std::span<char> GetScratchBuffer();
+    static void Push(LogLevel level, LogCategory category, std::string_view message, bool isTruncated);
+};
+
+}
+
+// `category` is the name of a LogCategory, e.g. LUMINA_LOG_INFO(Vulkan, "Using {}", deviceName)
+#define LUMINA_LOG(level, category, ...)                                                                     \
+    do {                                                                                                     \
+        if constexpr (static_cast<int>(level) >= LUMINA_LOG_LEVEL) {                                         \
+            ::Lumina::Essence::Log::Write(level, ::Lumina::Essence::LogCategory::category, __VA_ARGS__);     \
+        }                                                                                                    \
+    } while (false)
+
+#define LUMINA_LOG_TRACE(category, ...) LUMINA_LOG(::Lumina::Essence::LogLevel::Trace, category, __VA_ARGS__)
+#define LUMINA_LOG_DEBUG(category, ...) LUMINA_LOG(::Lumina::Essence::LogLevel::Debug, category, __VA_ARGS__)
+#define LUMINA_LOG_INFO(category, ...) LUMINA_LOG(::Lumina::Essence::LogLevel::Info, category, __VA_ARGS__)
+#define LUMINA_LOG_WARNING(category, ...) LUMINA_LOG(::Lumina::Essence::LogLevel::Warning, category, __VA_ARGS__)
+#define LUMINA_LOG_ERROR(category, ...) LUMINA_LOG(::Lumina::Essence::LogLevel::Error, category, __VA_ARGS__)
\ No newline at end of file
@@ -19,7 +19,7 @@ public:
     void DisableDepthTest();
     void SetPipelineLayout(vk::PipelineLayout layout);
 
-    vk::Pipeline Build(vk::Device device);
+    vk::Pipeline Build(vk::Device device, vk::PipelineCache pipelineCache = nullptr);
 
 private:
     std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace Lumina::Essence {
+
+class PipelineCache : NonCopyable {
+public:
+    // Loads the cache blob at `path` if it was written by the same device and driver, otherwise starts empty.
+    void Initialize(vk::PhysicalDevice physicalDevice, vk::Device device, std::string const& path);
+    // Failing to write the file is only logged, this runs during shutdown.
+    void Save();
+    void Destroy();
+
+    inline operator vk::PipelineCache() const {
+        return cache;
+    }
+
+    inline bool IsWarm() const {
+        return isWarm;
+    }
+
+private:
+    struct DeviceIdentity {
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        std::array<uint8_t, VK_UUID_SIZE> driverUUID;
+        std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUUID;
+    };
+
+    std::vector<uint8_t> LoadValidatedBlob() const;
+
+    vk::Device device;
+    vk::PipelineCache cache;
+    DeviceIdentity identity = {};
+    std::string path;
+    bool isWarm = false;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/PipelineBuilder.hpp"
+#include "Lumina/Essence/PipelineCache.hpp"
+#include "Lumina/Essence/RetirementQueue.hpp"
+#include "Lumina/Essence/Utils/AssetPack.hpp"
+#include "Lumina/Essence/Utils/JobSystem.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <compare>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// A pipeline that may still be compiling. Converting it to a vk::Pipeline blocks until it is done.
+class PipelineHandle {
+public:
+    PipelineHandle() = default;
+    explicit PipelineHandle(std::shared_future<vk::Pipeline> future);
+
+    vk::Pipeline Get() const;
+    bool IsReady() const;
+    // Only meaningful once IsReady(), a failed compilation throws from Get().
+    bool HasFailed() const;
+
+    // Waits for the compilation and destroys the pipeline if it succeeded.
+    void Destroy(vk::Device device);
+    // Like Destroy(), but the pipeline is only destroyed once the frame timeline reached `retireValue`.
+    void Retire(RetirementQueue& queue, uint64_t retireValue, char const* name = nullptr);
+
+    inline operator vk::Pipeline() const {
+        return Get();
+    }
+
+private:
+    std::shared_future<vk::Pipeline> future;
+};
+
+// A 32 bit specialization constant, which is all the shaders use.
+struct SpecializationConstant {
+    uint32_t id;
+    uint32_t value;
+
+    auto operator<=>(SpecializationConstant const& other) const = default;
+};
+
+class PipelineCompiler {
+public:
+    // Shaders are taken from `assetPack` if it holds them and from loose files otherwise.
+    void Initialize(vk::Device device, PipelineCache const& pipelineCache, JobSystem& jobSystem, AssetPack const* assetPack = nullptr);
+
+    // Loads `shaderPath` from its loose file from now on, e.g. because it was recompiled after the pack was built.
+    void BypassAssetPack(std::string const& shaderPath);
+
+    // Loads the SPIR-V and creates the pipeline on the job system. The layout must outlive the compilation.
+    PipelineHandle CompileCompute(std::string const& shaderPath, vk::PipelineLayout layout, std::vector<SpecializationConstant> const& constants = {});
+    PipelineHandle CompileGraphics(PipelineBuilder builder, std::string const& vertexShaderPath, std::string const& fragmentShaderPath);
+
+private:
+    template <typename F>
+    PipelineHandle Enqueue(std::string const& name, F&& compile);
+    vk::ShaderModule LoadShader(std::string const& shaderPath);
+
+    vk::Device device;
+    PipelineCache const* pipelineCache = nullptr;
+    JobSystem* jobSystem = nullptr;
+
+    AssetPack const* assetPack = nullptr;
+    std::mutex bypassMutex;
+    std::set<std::string> bypassedShaders;
+
+    // used to report how long a batch of back to back compilations took
+    std::atomic<uint32_t> numPending = 0;
+    std::atomic<std::chrono::steady_clock::rep> batchStart = 0;
+};
+
+}
\ No newline at end of file
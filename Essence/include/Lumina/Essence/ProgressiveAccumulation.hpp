@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Lumina::Essence {
+
+// Decides how many samples a progressively refined image gets each frame. While the inputs stay the same the
+// samples add up over several frames until `maxSamples`, after that nothing has to be rendered anymore.
+class ProgressiveAccumulation {
+public:
+    struct Settings {
+        bool enabled = true;
+        uint32_t samplesPerFrame = 1;
+        uint32_t maxSamples = 64;
+        uint32_t previewScale = 4;     // pixels per side of one preview sample, 1 disables the preview
+        uint32_t fullRenderSamples = 4; // samples per frame while disabled or while the inputs keep changing
+    };
+
+    // Work for a single frame. A `sampleIndex` of 0 starts a new accumulation.
+    struct Step {
+        bool needsDispatch = false;
+        uint32_t sampleIndex = 0;
+        uint32_t numSamples = 0;
+        uint32_t previewScale = 1;
+    };
+
+    // `inputsChanged` discards the accumulated samples. The first frame after a change only renders a
+    // coarse preview, the following ones refine at full resolution. Inputs that change every frame, e.g. an
+    // animation, get `fullRenderSamples` at full resolution each frame instead of a preview that never refines.
+    Step Advance(bool inputsChanged);
+    void Reset();
+
+    inline uint32_t GetNumSamples() const {
+        return numSamples;
+    }
+    inline bool IsConverged() const {
+        return settings.enabled && numSamples >= settings.maxSamples;
+    }
+
+    void DrawImGui();
+
+    Settings settings;
+
+private:
+    uint32_t numSamples = 0;
+    bool wereInputsChanged = false;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/GpuProfiler.hpp"
+#include "Lumina/Essence/SyncState.hpp"
+#include "Lumina/Essence/VulkanImage.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// Records the passes of a frame together with the resources they touch. Compile() culls passes whose
+// results are never used and derives the barriers between the remaining ones from the declared usages,
+// so passes that don't share resources aren't serialized. The graph is rebuilt every frame.
+class RenderGraph : NonCopyable {
+public:
+    using ResourceId = uint32_t;
+
+    // How a pass uses a resource. The layout is ignored for buffers.
+    struct Usage {
+        vk::PipelineStageFlags2 stage;
+        vk::AccessFlags2 access;
+        vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+    };
+
+    class PassBuilder {
+    public:
+        PassBuilder& Read(ResourceId resource, Usage const& usage);
+        PassBuilder& Write(ResourceId resource, Usage const& usage);
+        // The pass is never culled, e.g. because it writes something the graph doesn't know about.
+        PassBuilder& SetSideEffects();
+        PassBuilder& SetExecute(std::function<void(vk::CommandBuffer)>&& func);
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& graph, uint32_t passIndex);
+
+        PassBuilder& Use(ResourceId resource, Usage const& usage, bool isWrite);
+
+        RenderGraph& graph;
+        uint32_t passIndex;
+    };
+
+    // Forgets all passes and resources of the last frame.
+    void Reset();
+
+    // `lastUsage` is how the resource was used before this graph, the first pass synchronizes against it.
+    ResourceId ImportImage(std::string const& name, vk::Image image, vk::ImageAspectFlags aspect, Usage const& lastUsage);
+    // Starts from the state the image tracks and writes the final state back in Compile(). The image has to
+    // be in the same state in all of its subresources.
+    ResourceId ImportImage(std::string const& name, VulkanImage& image);
+    ResourceId ImportBuffer(std::string const& name, vk::Buffer buffer, Usage const& lastUsage);
+
+    // Passes execute in the order they were added.
+    PassBuilder AddPass(std::string const& name);
+
+    // Keeps the passes producing `resource` alive. With a `finalUsage` the resource is transitioned
+    // to it after the last pass, e.g. into ePresentSrcKHR.
+    void SetOutput(ResourceId resource, std::optional<Usage> finalUsage = std::nullopt);
+
+    void Compile();
+    // Every pass is wrapped in a profiler zone of the same name.
+    void Execute(vk::CommandBuffer cmd, GpuProfiler& profiler);
+
+    inline uint32_t GetNumCulledPasses() const {
+        return numCulledPasses;
+    }
+
+private:
+    struct Resource {
+        std::string name;
+        vk::Image image;
+        vk::Buffer buffer;
+        vk::ImageAspectFlags aspect;
+        SyncState state;
+        VulkanImage* trackedImage = nullptr;
+        bool isOutput = false;
+        std::optional<Usage> finalUsage;
+    };
+
+    struct ResourceUsage {
+        ResourceId resource;
+        Usage usage;
+        bool isRead = false;
+        bool isWrite = false;
+    };
+
+    struct Barriers {
+        std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+        std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+
+        void Clear();
+        void Record(vk::CommandBuffer cmd) const;
+    };
+
+    struct Pass {
+        std::string name;
+        std::vector<ResourceUsage> usages;
+        std::function<void(vk::CommandBuffer)> execute;
+        bool hasSideEffects = false;
+        bool isCulled = false;
+        Barriers barriers; // recorded before the pass
+    };
+
+    ResourceId AddResource(Resource&& resource);
+    void CullPasses();
+    void AddBarrier(Resource& resource, Usage const& usage, bool isWrite, Barriers& barriers);
+
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+    Barriers finalBarriers;
+    uint32_t numCulledPasses = 0;
+    bool isCompiled = false;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+#include "Lumina/Essence/Utils/Platform.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// Vulkan objects that submitted work may still use. Each one is tagged with the frame timeline value after
+// which it is safe to destroy and Collect() destroys everything the GPU is done with. Handles are kept in
+// one array per type, so once the arrays reached their working size neither retiring nor collecting
+// allocates, and nothing is logged. Names are only stored in debug builds.
+//
+// For init and shutdown work use DeletionQueue instead, this is for objects replaced while running.
+class RetirementQueue : NonCopyable {
+public:
+    void Initialize(vk::Device device, VmaAllocator allocator);
+
+    // `name` has to outlive the queue, it's meant for string literals
+    void Retire(vk::Pipeline pipeline, uint64_t retireValue, char const* name = nullptr);
+    void Retire(vk::ImageView imageView, uint64_t retireValue, char const* name = nullptr);
+    void Retire(vk::Image image, VmaAllocation allocation, uint64_t retireValue, char const* name = nullptr);
+    void Retire(vk::Buffer buffer, VmaAllocation allocation, uint64_t retireValue, char const* name = nullptr);
+    void Retire(vk::SwapchainKHR swapchain, uint64_t retireValue, char const* name = nullptr);
+
+    // Destroys everything retired with a value of at most `completedValue`.
+    void Collect(uint64_t completedValue);
+    // Destroys everything regardless of its value, the device has to be idle.
+    void DestroyAll();
+
+    size_t GetNumPending() const;
+
+private:
+    template <typename Handle>
+    struct Entry {
+        Handle handle;
+        uint64_t retireValue;
+#if defined(LUMINA_DEBUG)
+        char const* name;
+#endif
+    };
+
+    struct AllocatedImage {
+        vk::Image image;
+        VmaAllocation allocation;
+    };
+    struct AllocatedBuffer {
+        vk::Buffer buffer;
+        VmaAllocation allocation;
+    };
+
+    template <typename Handle>
+    static void Push(std::vector<Entry<Handle>>& entries, Handle handle, uint64_t retireValue, char const* name);
+    // Destroys the entries up to `completedValue` and moves the rest to the front, keeping their order.
+    template <typename Handle, typename F>
+    static void Collect(std::vector<Entry<Handle>>& entries, uint64_t completedValue, bool isLogging, F&& destroy);
+    void Collect(uint64_t completedValue, bool isLogging);
+
+    vk::Device device;
+    VmaAllocator allocator = nullptr;
+
+    std::vector<Entry<vk::Pipeline>> pipelines;
+    std::vector<Entry<vk::ImageView>> imageViews;
+    std::vector<Entry<AllocatedImage>> images;
+    std::vector<Entry<AllocatedBuffer>> buffers;
+    std::vector<Entry<vk::SwapchainKHR>> swapchains;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+#include "Lumina/Essence/Utils/JobSystem.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// Watches a directory of GLSL sources and recompiles the ones that change into the SPIR-V file next to
+// them (`gradient.comp` into `gradient.comp.spv`) as jobs, one per source. A failed compilation leaves the
+// old SPIR-V in place. Only Linux has a watcher (inotify), elsewhere nothing is ever recompiled.
+class ShaderHotReload : NonCopyable {
+public:
+    ~ShaderHotReload();
+
+    void Initialize(std::filesystem::path const& directory, std::string const& glslcPath, JobSystem& jobSystem);
+    void Destroy();
+
+    // SPIR-V files rewritten since the last call, with the directory prefixed like it was passed in.
+    std::vector<std::string> TakeRecompiledShaders();
+
+private:
+    void WatchLoop();
+    bool Compile(std::string const& sourceName);
+
+    std::filesystem::path directory;
+    std::string glslcPath;
+    JobSystem* jobSystem = nullptr;
+    JobCounter compileJobs; // changes pile up while a batch is still compiling
+
+    int inotifyFd = -1;
+    std::thread watcher;
+    std::atomic<bool> isStopping = false;
+
+    std::mutex mutex;
+    std::vector<std::string> recompiledShaders;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Lumina/Essence/VulkanBuffer.hpp"
+#include "Lumina/Essence/VulkanImage.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+namespace Lumina::Essence {
+
+// A persistently mapped upload buffer split into one region per frame in flight. Uploads are suballocated
+// linearly from the current frame's region and copied on the frame's command buffer, the region is reused
+// once that frame retired.
+class StagingRing : NonCopyable {
+public:
+    struct Allocation {
+        void* mappedData;
+        vk::Buffer buffer;
+        vk::DeviceSize offset;
+        vk::DeviceSize size;
+    };
+
+    void Initialize(Application& app, vk::DeviceSize bytesPerFrame, uint32_t numFrames);
+    void Destroy();
+
+    // The region of `frameIndex` must not be in use by the GPU anymore.
+    void BeginFrame(uint32_t frameIndex);
+
+    // Space in the current region, std::nullopt if the region is full.
+    std::optional<Allocation> Allocate(vk::DeviceSize size, vk::DeviceSize alignment = defaultAlignment);
+
+    // Copies `data` into the ring and records a copy to `target`. Returns false if the region is full.
+    bool Upload(vk::CommandBuffer cmd, vk::Buffer target, vk::DeviceSize targetOffset, std::span<const std::byte> data);
+    // Copies into the first mip and layer of `target` from the top left corner, `data` holds tightly packed
+    // texels of `extent`. Moves that subresource into eTransferDstOptimal through its tracked state.
+    bool Upload(vk::CommandBuffer cmd, VulkanImage& target, vk::Extent3D extent, std::span<const std::byte> data);
+
+    // Makes all copies recorded since the last call visible to later commands on `cmd`.
+    void FlushBarrier(vk::CommandBuffer cmd);
+
+    inline vk::DeviceSize GetUsedBytes() const {
+        return offset - regionBegin;
+    }
+
+    static constexpr vk::DeviceSize defaultAlignment = 16;
+
+private:
+    VulkanBuffer buffer;
+    vk::DeviceSize bytesPerFrame = 0;
+    vk::DeviceSize regionBegin = 0;
+    vk::DeviceSize offset = 0;
+
+    bool hasPendingCopies = false;
+};
+
+}
\ No newline at end of file
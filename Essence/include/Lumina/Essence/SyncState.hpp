@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+
+#include <optional>
+
+namespace Lumina::Essence {
+
+// Source half of a barrier, the destination half is the access that needed it.
+struct Dependency {
+    vk::PipelineStageFlags2 srcStage;
+    vk::AccessFlags2 srcAccess;
+    vk::ImageLayout oldLayout;
+};
+
+// Tracks how a resource (or a single image subresource) was accessed on the GPU, so the next access
+// only has to wait for what actually conflicts with it.
+struct SyncState {
+    vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+    vk::PipelineStageFlags2 writeStage;
+    vk::AccessFlags2 writeAccess;
+    vk::PipelineStageFlags2 readStages;    // stages that read since the last write
+    vk::PipelineStageFlags2 visibleStages; // stages the last write was made visible to
+    vk::AccessFlags2 visibleAccess;
+
+    // Treats everything before as a single write, used for resources coming from outside the tracking.
+    static SyncState FromLastAccess(vk::PipelineStageFlags2 stage, vk::AccessFlags2 access, vk::ImageLayout layout);
+
+    // Records an access and returns the barrier it needs, or std::nullopt if it's already synchronized.
+    // Pass `tracksLayout = false` for buffers.
+    std::optional<Dependency> Access(vk::PipelineStageFlags2 stage, vk::AccessFlags2 access, vk::ImageLayout newLayout, bool isWrite, bool tracksLayout = true);
+
+    bool operator==(SyncState const& other) const = default;
+};
+
+bool IsWriteAccess(vk::AccessFlags2 access);
+
+}
\ No newline at end of file
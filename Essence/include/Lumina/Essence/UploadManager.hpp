@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/VulkanBuffer.hpp"
+#include "Lumina/Essence/VulkanImage.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// Completion of an upload batch, the batch is done once the upload timeline reached `value`.
+struct UploadToken {
+    uint64_t value = 0;
+};
+
+// Records uploads on the transfer queue without blocking the CPU. Uploads are collected into a batch,
+// Submit() sends the whole batch in one submission that signals the upload timeline. The render loop then
+// waits for the token on the GPU and takes ownership of the resources if the transfer queue is a different
+// family. Not thread safe, call it from the render thread.
+class UploadManager : NonCopyable {
+public:
+    void Initialize(Application& app, vk::Device device, vk::Queue transferQueue, uint32_t transferQueueFamily, uint32_t graphicsQueueFamily);
+    void Destroy();
+
+    void UploadBuffer(vk::Buffer target, vk::DeviceSize targetOffset, std::span<const std::byte> data);
+    // `data` holds tightly packed texels of the first mip and layer, the image ends up in `finalLayout` on the
+    // graphics queue and its tracked state is updated for the first use after WaitForUpload(). The image must
+    // not be in use by the GPU. With a separate transfer family its previous contents are discarded.
+    void UploadImage(VulkanImage& target, vk::Extent3D extent, std::span<const std::byte> data, vk::ImageLayout finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal);
+
+    // Submits all uploads since the last call, returns the token of the previous batch if there are none.
+    UploadToken Submit();
+
+    bool IsComplete(UploadToken token) const;
+    void WaitOnHost(UploadToken token) const;
+
+    // Records the ownership acquire barriers of every batch up to `token` that weren't acquired yet into `cmd`,
+    // no matter whether the batches already completed. The submission of `cmd` has to wait on the returned semaphore.
+    vk::SemaphoreSubmitInfo Acquire(vk::CommandBuffer cmd, UploadToken token);
+
+    // Recycles the staging memory and command buffers of completed batches. Their acquire barriers are kept
+    // until Acquire() records them.
+    void CollectCompleted();
+
+    static constexpr vk::DeviceSize stagingChunkSize = 8 * 1024 * 1024;
+    static constexpr size_t maxFreeStagingChunks = 4; // more are destroyed once their batch completed
+
+private:
+    // Acquire barriers of a submitted batch, they outlive the batch until a frame records them.
+    struct PendingAcquire {
+        uint64_t value = 0;
+        std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+        std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+    };
+
+    struct Batch {
+        vk::CommandBuffer cmd;
+        std::vector<VulkanBuffer> stagingBuffers;
+        vk::DeviceSize chunkOffset = 0;
+
+        PendingAcquire acquire;
+        std::vector<vk::BufferMemoryBarrier2> releaseBufferBarriers;
+        std::vector<vk::ImageMemoryBarrier2> releaseImageBarriers;
+
+        uint64_t value = 0;
+    };
+
+    void BeginBatch();
+    std::pair<vk::Buffer, vk::DeviceSize> Stage(std::span<const std::byte> data);
+    bool NeedsOwnershipTransfer() const;
+
+    Application* app = nullptr;
+    vk::Device device;
+    vk::Queue transferQueue;
+    uint32_t transferQueueFamily = 0;
+    uint32_t graphicsQueueFamily = 0;
+
+    vk::CommandPool commandPool;
+    std::vector<vk::CommandBuffer> freeCommandBuffers;
+    std::vector<VulkanBuffer> freeStagingChunks; // all stagingChunkSize big
+
+    vk::Semaphore timeline;
+    uint64_t lastSubmittedValue = 0;
+
+    std::optional<Batch> openBatch;
+    std::deque<Batch> submittedBatches;         // ordered by value
+    std::deque<PendingAcquire> pendingAcquires; // ordered by value
+};
+
+}
\ No newline at end of file
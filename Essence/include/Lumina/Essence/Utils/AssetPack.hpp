@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// A read only archive of files that is memory mapped as a whole, so assets are used straight from the
+// mapping without being read or copied. Files are stored relative to the directory of the pack, a pack at
+// `resources/shaders.lpk` holding `shaders/gradient.comp.spv` answers to `resources/shaders/gradient.comp.spv`.
+//
+// layout: Header, Entry per file sorted by name hash, file names, file contents each at `alignment`
+class AssetPack : NonCopyable {
+public:
+    struct File {
+        std::string name; // relative to the directory of the pack
+        std::vector<uint8_t> bytes;
+    };
+
+    AssetPack() = default;
+    ~AssetPack();
+
+    // Throws if the file isn't a valid pack. In debug builds the contents are checked against their hashes.
+    void Open(std::filesystem::path const& path);
+    void Close();
+
+    inline bool IsOpen() const {
+        return !mapping.empty();
+    }
+
+    // The contents of the file at `path` or std::nullopt if the pack doesn't hold it. Stays valid until Close().
+    std::optional<std::span<const uint8_t>> Find(std::string_view path) const;
+
+    // Writes a pack holding `files`, the contents start at multiples of `alignment`.
+    static void Write(std::filesystem::path const& path, std::vector<File> const& files, uint32_t alignment = defaultAlignment);
+
+    static constexpr uint32_t defaultAlignment = 16; // SPIR-V needs 4, vectorized readers like more
+
+private:
+    struct Entry;
+
+    std::span<const Entry> GetEntries() const;
+    void Validate() const;
+
+    std::span<const uint8_t> mapping;
+    std::vector<uint8_t> fallbackBytes; // where there is no mmap
+    std::string prefix;                 // directory of the pack, stripped from looked up paths
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cmath>
+
+namespace Lumina::Essence {
+
+// Unevaluated sum of two doubles, about 106 bits of mantissa. Only what the deep zoom needs.
+struct DoubleDouble {
+    double hi = 0;
+    double lo = 0;
+
+    DoubleDouble() = default;
+    DoubleDouble(double value)
+        : hi(value) {}
+    DoubleDouble(double hi, double lo)
+        : hi(hi), lo(lo) {}
+
+    explicit operator double() const {
+        return hi + lo;
+    }
+};
+
+namespace Detail {
+
+// exact sum, a + b = s + e
+inline DoubleDouble TwoSum(double a, double b) {
+    double s = a + b;
+    double v = s - a;
+    double e = (a - (s - v)) + (b - v);
+    return {s, e};
+}
+// requires |a| >= |b|
+inline DoubleDouble QuickTwoSum(double a, double b) {
+    double s = a + b;
+    return {s, b - (s - a)};
+}
+// exact product, a * b = p + e
+inline DoubleDouble TwoProd(double a, double b) {
+    double p = a * b;
+    return {p, std::fma(a, b, -p)};
+}
+
+}
+
+inline DoubleDouble operator+(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble s = Detail::TwoSum(a.hi, b.hi);
+    DoubleDouble t = Detail::TwoSum(a.lo, b.lo);
+    s = Detail::QuickTwoSum(s.hi, s.lo + t.hi);
+    return Detail::QuickTwoSum(s.hi, s.lo + t.lo);
+}
+inline DoubleDouble operator-(DoubleDouble a) {
+    return {-a.hi, -a.lo};
+}
+inline DoubleDouble operator-(DoubleDouble a, DoubleDouble b) {
+    return a + -b;
+}
+inline DoubleDouble operator*(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble p = Detail::TwoProd(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return Detail::QuickTwoSum(p.hi, p.lo);
+}
+
+inline DoubleDouble& operator+=(DoubleDouble& a, DoubleDouble b) {
+    return a = a + b;
+}
+inline DoubleDouble& operator-=(DoubleDouble& a, DoubleDouble b) {
+    return a = a - b;
+}
+
+}
\ No newline at end of file
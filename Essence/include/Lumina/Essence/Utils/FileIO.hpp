@@ -3,9 +3,13 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <span>
 
 namespace Lumina::Essence {
 
 std::vector<uint8_t> ReadBinaryFile(std::string const& path);
 
+// Writes to a temporary file first and renames it over `path`, so readers never see a partial file.
+void WriteBinaryFileAtomically(std::string const& path, std::span<const uint8_t> bytes);
+
 }
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace Lumina::Essence {
+
+constexpr uint64_t Fnv1a64(std::span<const uint8_t> bytes, uint64_t hash = 0xcbf29ce484222325) {
+    for (uint8_t byte : bytes) {
+        hash ^= byte;
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+}
\ No newline at end of file
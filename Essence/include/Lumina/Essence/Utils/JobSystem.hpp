@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// Counts the unfinished jobs started with it. Other jobs can depend on a counter to only start once it is
+// done, and JobSystem::Wait() blocks on it. A counter can be reused once it is done and nothing depends on it.
+// It has to outlive all jobs it counts.
+class JobCounter : NonCopyable {
+public:
+    // Use JobSystem::Wait() before destroying the counter, the last job may still be finishing.
+    inline bool IsDone() const {
+        return numPending.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> numPending = 0;
+
+    std::mutex mutex;
+    std::vector<std::function<void()>> dependents; // queued once numPending drops to zero
+};
+
+// Every worker owns a queue. Jobs submitted from a worker go to its own queue and are taken newest first,
+// idle workers steal the oldest jobs of the others. Jobs from other threads are spread over all queues.
+// Jobs with a dependency aren't queued at all until it is done, so they never block a worker.
+//
+// Long jobs, e.g. compiling or waiting on a process, go to a separate queue. Only workers with nothing else to
+// do take them and, unless there is only a single worker, at least one is always left for the short ones.
+// Threads in Wait() never run them, so a frame waiting on its own jobs can't get stuck behind one.
+//
+// A job that throws is logged and counts as finished.
+class JobSystem : NonCopyable {
+public:
+    using Job = std::function<void()>;
+
+    explicit JobSystem(uint32_t numThreads = std::max(1u, std::thread::hardware_concurrency()));
+    ~JobSystem();
+
+    // Queues `job` once `dependency` is done, right away without one. `counter` counts it until it finished.
+    void Run(Job&& job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+    // Queues `job` on the queue for long jobs. Long jobs must not wait on other long jobs.
+    void RunLong(Job&& job, JobCounter* counter = nullptr);
+
+    // Runs queued short jobs on the calling thread until `counter` is done and sleeps while there are none, so
+    // this is safe to call from inside a job. The counter can be destroyed once this returned, but not right
+    // after IsDone() turned true.
+    void Wait(JobCounter& counter);
+
+    template <typename F>
+    auto Submit(F&& func) -> std::future<std::invoke_result_t<F>> {
+        auto [job, future] = Package(std::forward<F>(func));
+        Run(std::move(job));
+        return std::move(future);
+    }
+    template <typename F>
+    auto SubmitLong(F&& func) -> std::future<std::invoke_result_t<F>> {
+        auto [job, future] = Package(std::forward<F>(func));
+        RunLong(std::move(job));
+        return std::move(future);
+    }
+
+    // Calls `func(begin, end)` for consecutive ranges of at most `grainSize` elements covering [0, count)
+    // without waiting for them, `counter` is done once all ranges are. `func` is copied into the jobs.
+    template <typename F>
+    void ParallelForRange(uint32_t count, uint32_t grainSize, F&& func, JobCounter& counter, JobCounter* dependency = nullptr) {
+        grainSize = std::max(grainSize, 1u);
+        auto sharedFunc = std::make_shared<std::decay_t<F>>(std::forward<F>(func));
+        for (uint32_t begin = 0; begin < count; begin += grainSize) {
+            const uint32_t end = std::min(count, begin + grainSize);
+            Run([sharedFunc, begin, end]() { (*sharedFunc)(begin, end); }, &counter, dependency);
+        }
+    }
+
+    // Calls `func(i)` for every i in [0, count) and returns once all calls finished. The calling thread
+    // works on the ranges too, so this is safe to call from inside a job.
+    template <typename F>
+    void ParallelFor(uint32_t count, F&& func, uint32_t grainSize = 1) {
+        JobCounter counter;
+        ParallelForRange(
+            count,
+            grainSize,
+            [&func](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    func(i);
+                }
+            },
+            counter
+        );
+        Wait(counter);
+    }
+
+    inline uint32_t GetThreadCount() const {
+        return static_cast<uint32_t>(workers.size());
+    }
+
+    // Index of the calling thread in [0, GetThreadCount()), std::nullopt if it isn't a worker of this system.
+    std::optional<uint32_t> GetCurrentWorkerIndex() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    template <typename F>
+    static auto Package(F&& func) -> std::pair<Job, std::future<std::invoke_result_t<F>>> {
+        using Result = std::invoke_result_t<F>;
+
+        // std::function needs to be copyable, packaged_task isn't
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+        std::future<Result> future = task->get_future();
+        return {[task]() { (*task)(); }, std::move(future)};
+    }
+
+    // Makes `job` count towards `counter`, also if it throws.
+    Job Count(Job&& job, JobCounter& counter);
+    void Push(Job&& job);
+    void Finish(JobCounter& counter);
+    static void Execute(Job& job);
+    // Runs one queued short job on the calling thread, returns false if there was none.
+    bool TryRunJob();
+    // Same for long jobs, returns false if there was none or enough of them are running already.
+    bool TryRunLongJob();
+    bool TryPop(uint32_t queueIndex, Job& job);
+    bool TrySteal(uint32_t thiefIndex, Job& job);
+    void WorkerLoop(uint32_t index);
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::atomic<uint32_t> nextQueue = 0;
+
+    // sleeping workers wait here until there is something to do, threads in Wait() until there is a short job
+    // or a counter finished
+    std::mutex sleepMutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable waitProgress;
+    std::atomic<uint32_t> numQueuedJobs = 0;
+    uint32_t numWaitingThreads = 0;
+    bool isStopping = false;
+
+    // guarded by sleepMutex
+    std::deque<Job> longJobs;
+    uint32_t numRunningLongJobs = 0;
+    uint32_t maxRunningLongJobs = 1;
+};
+
+}
\ No newline at end of file
@@ -30,4 +30,12 @@ enum class BuildMode {
 #else
     #error "Unknown compiler."
 #endif
+
+#if defined(__linux__)
+    #define LUMINA_PLATFORM_LINUX
+#elif defined(_WIN32)
+    #define LUMINA_PLATFORM_WINDOWS
+#elif defined(__APPLE__)
+    #define LUMINA_PLATFORM_MACOS
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <utility>
+
+namespace Lumina::Essence {
+
+// Calls `func` when leaving the scope, also when it's left by an exception.
+template <typename Func>
+class ScopeGuard : NonCopyable {
+public:
+    explicit ScopeGuard(Func func) : func(std::move(func)) {}
+    ~ScopeGuard() {
+        func();
+    }
+
+private:
+    Func func;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Lumina::Essence {
+
+// Hands the newest value from one writer thread to one reader thread without either of them ever waiting.
+// Both own a slot and share the third one: the writer swaps its finished slot into the shared one, the
+// reader swaps the shared one out if it holds something newer. Values the reader didn't pick up in time
+// are overwritten.
+template <typename T>
+class TripleBuffer : NonCopyable {
+public:
+    // Writer only. Keeps whatever was written into this slot three publishes ago, so either overwrite all of it
+    // or keep the parts that never change.
+    inline T& GetWriteBuffer() {
+        return slots[writeIndex];
+    }
+
+    // Writer only. Makes the write buffer the newest value and hands out another slot to write next.
+    inline void Publish() {
+        writeIndex = shared.exchange(writeIndex | newBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader only. Picks up the newest value if there is one, returns false if nothing was published since.
+    inline bool Update() {
+        if ((shared.load(std::memory_order_relaxed) & newBit) == 0) {
+            return false;
+        }
+        readIndex = shared.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    // Reader only. The value picked up by the last Update(), a default constructed one before that.
+    inline T const& GetReadBuffer() const {
+        return slots[readIndex];
+    }
+
+private:
+    static constexpr uint8_t indexMask = 0x3;
+    static constexpr uint8_t newBit = 0x4; // the shared slot was published and not picked up yet
+
+    std::array<T, 3> slots = {};
+    alignas(64) std::atomic<uint8_t> shared = 1;
+    alignas(64) uint8_t writeIndex = 0;
+    alignas(64) uint8_t readIndex = 2;
+};
+
+}
\ No newline at end of file
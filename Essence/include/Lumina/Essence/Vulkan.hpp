@@ -5,11 +5,15 @@
 
 #include <vk_mem_alloc.h>    // IWYU pragma: export
 
+#include <span>
+
 namespace Lumina::Essence {
 
 vk::ImageSubresourceRange CreateSubresourceRangeForAllLayers(vk::ImageAspectFlags aspect);
 vk::RenderingInfo CreateRenderingInfo(vk::Extent2D renderExtent, vk::RenderingAttachmentInfo& colorAttachment, vk::RenderingAttachmentInfo* depthAttachment);
 vk::ShaderModule LoadShaderModule(std::string const& filename, vk::Device device);
+// Creates the module straight from `code`, which has to be 4 byte aligned SPIR-V, e.g. from an AssetPack.
+vk::ShaderModule LoadShaderModule(std::span<const uint8_t> code, vk::Device device);
 
 template <typename T>
 [[nodiscard]]
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/RetirementQueue.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+namespace Lumina::Essence {
+
+class Application;
+
+class VulkanBuffer : NonCopyable {
+public:
+    // Pass VMA_ALLOCATION_CREATE_MAPPED_BIT with a host access flag to get a persistently mapped buffer.
+    VulkanBuffer(Application& app, vk::DeviceSize size, vk::BufferUsageFlags usageFlags, VmaMemoryUsage memoryUsage, VmaAllocationCreateFlags allocationFlags = 0);
+    VulkanBuffer();
+    VulkanBuffer(VulkanBuffer&& other) noexcept;            // allow moving
+    VulkanBuffer& operator=(VulkanBuffer&& other) noexcept; // allow moving
+
+    ~VulkanBuffer();
+
+    inline operator vk::Buffer() const {
+        return buffer;
+    }
+
+    inline vk::DeviceSize GetSize() const {
+        return size;
+    }
+
+    // nullptr unless the buffer is persistently mapped
+    inline void* GetMappedData() const {
+        return mappedData;
+    }
+
+    // 0 unless the buffer was created with eShaderDeviceAddress
+    inline vk::DeviceAddress GetDeviceAddress() const {
+        return deviceAddress;
+    }
+
+    // Makes host writes to a mapped buffer visible to the device, does nothing for coherent memory.
+    void FlushMappedRange(vk::DeviceSize offset, vk::DeviceSize size);
+    // Makes device writes to a mapped buffer visible to the host, does nothing for coherent memory.
+    void InvalidateMappedRange(vk::DeviceSize offset, vk::DeviceSize size);
+
+    void Destroy();
+    // Hands the buffer to `queue` to be destroyed once the frame timeline reached `retireValue`.
+    void Retire(RetirementQueue& queue, uint64_t retireValue, char const* name = nullptr);
+
+private:
+    Application* app = nullptr;
+
+    vk::Buffer buffer;
+    VmaAllocation allocation;
+    vk::DeviceSize size;
+    void* mappedData;
+    vk::DeviceAddress deviceAddress;
+
+    bool destroyed = true;
+};
+
+}
\ No newline at end of file
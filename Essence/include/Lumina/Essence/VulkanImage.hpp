@@ -1,15 +1,29 @@
 #pragma once
 
 #include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/SyncState.hpp"
+#include "Lumina/Essence/RetirementQueue.hpp"
 #include "Lumina/Essence/Utils/NonCopyable.hpp"
 
+#include <vector>
+
 namespace Lumina::Essence {
 
 class Application;
 
 class VulkanImage : NonCopyable {
 public:
-    VulkanImage(Application& app, vk::Format format, vk::ImageUsageFlags usageFlags, vk::Extent3D extent, vk::ImageAspectFlags aspectFlags);
+    // Collects transitions of several images so they are recorded as a single dependency.
+    class TransitionBatch {
+    public:
+        void Record(vk::CommandBuffer cmd);
+
+    private:
+        friend class VulkanImage;
+        std::vector<vk::ImageMemoryBarrier2> barriers;
+    };
+
+    VulkanImage(Application& app, vk::Format format, vk::ImageUsageFlags usageFlags, vk::Extent3D extent, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels = 1, uint32_t arrayLayers = 1);
     VulkanImage();
     VulkanImage(VulkanImage&& other) noexcept;            // allow moving
     VulkanImage& operator=(VulkanImage&& other) noexcept; // allow moving
@@ -31,10 +45,36 @@ public:
         return imageFormat;
     }
 
+    inline vk::ImageAspectFlags GetAspect() const {
+        return aspectFlags;
+    }
+
+    inline uint32_t GetMipLevels() const {
+        return mipLevels;
+    }
+
+    inline uint32_t GetArrayLayers() const {
+        return arrayLayers;
+    }
+
     void Destroy();
+    // Hands the image to `queue` to be destroyed once the frame timeline reached `retireValue`.
+    void Retire(RetirementQueue& queue, uint64_t retireValue, char const* name = nullptr);
+
+    // Moves the subresources in `range` into `layout` for an access by `stage`. Only waits for the accesses
+    // that conflict with it, nothing is recorded if the subresources are already usable like this.
+    void TransitionTo(vk::CommandBuffer cmd, vk::ImageLayout layout, vk::PipelineStageFlags2 stage, vk::AccessFlags2 access);
+    void TransitionTo(vk::CommandBuffer cmd, vk::ImageLayout layout, vk::PipelineStageFlags2 stage, vk::AccessFlags2 access, vk::ImageSubresourceRange const& range);
+    void TransitionTo(TransitionBatch& batch, vk::ImageLayout layout, vk::PipelineStageFlags2 stage, vk::AccessFlags2 access, vk::ImageSubresourceRange const& range);
+
+    // State of the first subresource, for images that are always used as a whole.
+    inline SyncState const& GetState() const {
+        return subresourceStates.at(0);
+    }
+    // For commands recorded without TransitionTo(), e.g. by the render graph. Applies to all subresources.
+    void SetState(SyncState const& state);
 
     static void Blit(vk::CommandBuffer cmd, vk::Image source, vk::Image target, vk::Extent2D sourceSize, vk::Extent2D targetSize);
-    static void Transition(vk::CommandBuffer cmd, vk::Image img, vk::ImageLayout srcLayout, vk::ImageLayout dstLayout);
 
 private:
     Application* app = nullptr;
@@ -44,6 +84,11 @@ private:
     VmaAllocation allocation;
     vk::Extent3D imageExtent;
     vk::Format imageFormat;
+    vk::ImageAspectFlags aspectFlags;
+    uint32_t mipLevels = 1;
+    uint32_t arrayLayers = 1;
+
+    std::vector<SyncState> subresourceStates; // indexed by layer * mipLevels + mip
 
     bool destroyed = true;
 };
@@ -22,6 +22,9 @@ public:
         return window;
     }
 
+    glm::ivec2 GetPixelSize() const;
+    glm::ivec2 GetSize() const; // in the coordinates of mouse events
+
     vk::SurfaceKHR CreateWindowSurface(vk::Instance instance) const;
 
 private:
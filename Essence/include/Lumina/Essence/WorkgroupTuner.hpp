@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Lumina/Essence/Vulkan.hpp"
+#include "Lumina/Essence/Utils/NonCopyable.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Lumina::Essence {
+
+// Finds the fastest workgroup shape of 2D compute kernels on the current device and remembers it in a
+// file, keyed by the device UUID, so the benchmark only runs once per device.
+class WorkgroupTuner : NonCopyable {
+public:
+    struct Shape {
+        uint32_t x = 16;
+        uint32_t y = 16;
+    };
+
+    // Records a submission and waits for it to finish.
+    using SubmitFunction = std::function<void(std::function<void(vk::CommandBuffer)>&&)>;
+    // Records one dispatch of the kernel using `shape`, including binding its pipeline.
+    using DispatchFunction = std::function<void(vk::CommandBuffer, Shape)>;
+
+    void Initialize(vk::PhysicalDevice physicalDevice, vk::Device device, uint32_t queueFamily, std::string const& path);
+    void Destroy();
+
+    std::optional<Shape> GetStoredShape(std::string const& kernel) const;
+
+    // Shapes worth trying that fit the device limits.
+    std::vector<Shape> GetCandidates() const;
+
+    // Times every candidate and stores the fastest. Without timestamp support it gives up and returns the default.
+    Shape Tune(std::string const& kernel, SubmitFunction const& submit, DispatchFunction const& dispatch);
+
+    void Save() const;
+
+    static constexpr uint32_t numTimedDispatches = 4;
+
+private:
+    void Load();
+    std::string GetKey(std::string const& kernel) const;
+
+    vk::Device device;
+    vk::QueryPool queryPool;
+    bool isTimestampSupported = false;
+    float timestampPeriod = 1; // nanoseconds per tick
+    vk::PhysicalDeviceLimits limits;
+
+    std::string deviceId; // hex encoded device UUID
+    std::string path;
+    std::map<std::string, Shape> shapes; // by "<device UUID> <kernel>"
+};
+
+}
\ No newline at end of file
@@ -3,8 +3,9 @@
 
 #include "Lumina/Essence/Application.hpp"
 #include "Lumina/Essence/PipelineBuilder.hpp"
-#include "Lumina/Essence/DescriptorLayoutBuilder.hpp"
 #include "Lumina/Essence/Utils/Packed.hpp"
+#include "Lumina/Essence/Utils/ScopeGuard.hpp"
+#include "Lumina/Essence/Log.hpp"
 
 #include <VkBootstrap.h>
 
@@ -18,46 +19,97 @@
 #include <backends/imgui_impl_sdl3.h>
 #include <misc/cpp/imgui_stdlib.h>
 
-#include <iostream>
+#include <algorithm>
 #include <chrono>
+#include <filesystem>
+#include <memory>
 #include <thread>
 
 namespace Lumina::Essence {
 
-Application::Application(glm::ivec2 windowSize, std::string const& windowTitle)
+namespace {
+
+// how many late ticks the tick thread runs back to back before it gives up and skips them
+constexpr uint32_t maxCatchUpTicks = 8;
+
+constexpr auto triangleVertexShaderPath = "resources/shaders/colored_triangle.vert.spv";
+constexpr auto triangleFragmentShaderPath = "resources/shaders/colored_triangle.frag.spv";
+
+// constant ids of local_size_x_id and local_size_y_id in the compute shaders
+std::vector<SpecializationConstant> GetWorkgroupConstants(WorkgroupTuner::Shape shape) {
+    return {
+        {0, shape.x},
+        {1, shape.y},
+    };
+}
+
+}
+
+Application::Application(glm::ivec2 windowSize, std::string const& windowTitle, DisplayMode displayMode)
     : name(windowTitle),
-      window(windowSize, windowTitle),
       windowTitle(windowTitle),
       windowSize(windowSize),
       allocator(),
       swapchainImageFormat(),
-      graphicsQueueFamily() {}
+      graphicsQueueFamily(),
+      transferQueueFamily() {
+    if (displayMode == DisplayMode::Windowed) {
+        window.emplace(windowSize, windowTitle);
+    }
+}
 
 Application::~Application() {
-    std::cout << "Application shutting down...\n";
+    LUMINA_LOG_INFO(General, "Application shutting down...");
 
     device.waitIdle();
 
+    // resources retired at runtime need the device and allocator to still be alive
+    retirementQueue.DestroyAll();
     mainDeletionQueue.Flush();
 }
 
 void Application::Initialize() {
-    std::cout << "Initializing Application\n";
+    LUMINA_LOG_INFO(General, "Initializing Application");
 
-    InitVulkan();
-    InitSwapchain();
-    InitCommands();
-    InitSyncObjects();
-    InitDescriptors();
-    InitPipelines();
-    InitImgui();
+    if (framesInFlight < 1 || framesInFlight > maxFramesInFlight) {
+        throw std::invalid_argument(
+            std::format("framesInFlight has to be between 1 and {}, but is {}", maxFramesInFlight, framesInFlight)
+        );
+    }
+    frames.resize(framesInFlight);
+
+    if (isTickThreadEnabled && !(tickRate > 0)) {
+        throw std::invalid_argument(std::format("tickRate has to be positive, but is {}", tickRate));
+    }
+
+    startupPhases.clear();
+    auto runPhase = [this](std::string name, void (Application::*init)()) {
+        auto start = std::chrono::steady_clock::now();
+        (this->*init)();
+        startupPhases.push_back({
+            std::move(name),
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+        });
+    };
+
+    runPhase("vulkan", &Application::InitVulkan);
+    runPhase("swapchain", &Application::InitSwapchain);
+    runPhase("commands", &Application::InitCommands);
+    runPhase("sync objects", &Application::InitSyncObjects);
+    runPhase("profiler", &Application::InitProfiler);
+    runPhase("uploads", &Application::InitUploads);
+    runPhase("descriptors", &Application::InitDescriptors);
+    runPhase("pipelines", &Application::InitPipelines);
+    runPhase("workgroup tuning", &Application::InitWorkgroupTuning);
+    runPhase("shader hot reload", &Application::InitShaderHotReload);
+    runPhase("imgui", &Application::InitImgui);
 
     isInitialized = true;
 }
 
 
 void Application::InitVulkan() {
-    std::cout << "Initializing vulkan\n";
+    LUMINA_LOG_INFO(Vulkan, "Initializing vulkan");
     VULKAN_HPP_DEFAULT_DISPATCHER.init();
 
     vkb::InstanceBuilder builder;
@@ -67,6 +119,7 @@ void Application::InitVulkan() {
                                     .set_engine_version(1, 0, 0)
                                     .request_validation_layers(BuildMode::Current == BuildMode::Debug)
                                     .set_debug_callback(VulkanDebugCallback)
+                                    .set_headless(IsHeadless())
                                     .require_api_version(1, 3, 0)
                                     .build()
                                     .value();
@@ -81,24 +134,36 @@ void Application::InitVulkan() {
         "debug messenger"
     );
 
-    surface = window.CreateWindowSurface(instance);
-    mainDeletionQueue.PushBack([&]() { instance.destroySurfaceKHR(surface); }, "surface");
+    if (!IsHeadless()) {
+        surface = window->CreateWindowSurface(instance);
+        mainDeletionQueue.PushBack([&]() { instance.destroySurfaceKHR(surface); }, "surface");
+    }
 
     vk::PhysicalDeviceVulkan12Features features12;
     features12.bufferDeviceAddress = vk::True;
     features12.descriptorIndexing = vk::True;
+    features12.timelineSemaphore = vk::True;
+    features12.runtimeDescriptorArray = vk::True;
+    features12.descriptorBindingPartiallyBound = vk::True;
+    features12.descriptorBindingStorageImageUpdateAfterBind = vk::True;
+    features12.descriptorBindingSampledImageUpdateAfterBind = vk::True;
+    features12.descriptorBindingStorageBufferUpdateAfterBind = vk::True;
 
     vk::PhysicalDeviceVulkan13Features features13;
     features13.dynamicRendering = vk::True;
     features13.synchronization2 = vk::True;
 
+    // a headless instance makes the selector skip presentation support, which also lets software
+    // implementations like lavapipe through (force one with VK_ICD_FILENAMES)
     vkb::PhysicalDeviceSelector selector(vkbInstance);
-    vkb::PhysicalDevice vkbPhysicalDevice = selector.set_minimum_version(1, 3)
-                                                .set_required_features_12(features12)
-                                                .set_required_features_13(features13)
-                                                .set_surface(surface)
-                                                .select()
-                                                .value();
+    selector.set_minimum_version(1, 3)
+        .set_required_features_12(features12)
+        .set_required_features_13(features13)
+        .allow_any_gpu_device_type(true);
+    if (!IsHeadless()) {
+        selector.set_surface(surface);
+    }
+    vkb::PhysicalDevice vkbPhysicalDevice = selector.select().value();
 
     vkb::DeviceBuilder deviceBuilder(vkbPhysicalDevice);
     vkb::Device vkbDevice = deviceBuilder.build().value();
@@ -109,7 +174,21 @@ void Application::InitVulkan() {
     graphicsQueue = vkbDevice.get_queue(vkb::QueueType::graphics).value();
     graphicsQueueFamily = vkbDevice.get_queue_index(vkb::QueueType::graphics).value();
 
-    std::cout << "Using " << physicalDevice.getProperties().deviceName << "\n";
+    // prefer a transfer-only family so uploads overlap with rendering, fall back to the graphics queue
+    if (auto dedicatedQueue = vkbDevice.get_dedicated_queue(vkb::QueueType::transfer)) {
+        transferQueue = dedicatedQueue.value();
+        transferQueueFamily = vkbDevice.get_dedicated_queue_index(vkb::QueueType::transfer).value();
+    }
+    else if (auto separateQueue = vkbDevice.get_queue(vkb::QueueType::transfer)) {
+        transferQueue = separateQueue.value();
+        transferQueueFamily = vkbDevice.get_queue_index(vkb::QueueType::transfer).value();
+    }
+    else {
+        transferQueue = graphicsQueue;
+        transferQueueFamily = graphicsQueueFamily;
+    }
+
+    LUMINA_LOG_INFO(Vulkan, "Using {}", std::string_view(physicalDevice.getProperties().deviceName));
 
     VmaAllocatorCreateInfo allocatorInfo = {};
     allocatorInfo.physicalDevice = physicalDevice;
@@ -119,50 +198,38 @@ void Application::InitVulkan() {
     vmaCreateAllocator(&allocatorInfo, &allocator);
     mainDeletionQueue.PushBack([&]() { vmaDestroyAllocator(allocator); }, "allocator");
 
-    std::cout << "Vulkan initialized\n";
+    retirementQueue.Initialize(device, allocator);
+
+    LUMINA_LOG_INFO(Vulkan, "Vulkan initialized");
 }
 void Application::InitSwapchain() {
-    std::cout << "Initializing swapchain\n";
-
-    CreateSwapchain(windowSize);
-
-    vk::Extent3D drawImageExtent = {
-        windowSize.x,
-        windowSize.y,
-        1,
-    };
+    LUMINA_LOG_INFO(General, "Initializing swapchain");
 
-    using enum vk::ImageUsageFlagBits;
-    drawImage = VulkanImage(
-        *this,
-        vk::Format::eR16G16B16A16Sfloat,
-        eTransferSrc | eTransferDst | eStorage | eColorAttachment,
-        drawImageExtent,
-        vk::ImageAspectFlagBits::eColor
-    );
+    if (!IsHeadless()) {
+        CreateSwapchain(windowSize);
+        mainDeletionQueue.PushBack([&]() { DestroySwapchain(); }, "swapchain");
+    }
 
+    CreateDrawImage({windowSize.x, windowSize.y});
     mainDeletionQueue.PushBack([&]() { drawImage.Destroy(); }, "draw image");
+    mainDeletionQueue.PushBack([&]() { accumulationImage.Destroy(); }, "accumulation image");
 
-    std::cout << "Swapchain initialized\n";
+    LUMINA_LOG_INFO(General, "Swapchain initialized");
 }
 
 void Application::InitCommands() {
-    std::cout << "Initializing commands\n";
+    LUMINA_LOG_INFO(General, "Initializing commands");
 
-    vk::CommandPoolCreateInfo commandPoolInfo = {{vk::CommandPoolCreateFlagBits::eResetCommandBuffer}, graphicsQueueFamily};
+    // one pool for the frame thread, the tick thread and every worker that may record batches
+    const uint32_t numRecordingThreads = jobSystem.GetThreadCount() + 2;
     int i = 0;
     for (auto& frame : frames) {
-        frame.commandPool = device.createCommandPool(commandPoolInfo);
-        mainDeletionQueue.PushBack([=, this]() { device.destroyCommandPool(frame.commandPool); }, std::format("command pool F{}", i));
-
-        frame.mainCommandBuffer = device.allocateCommandBuffers({
-            frame.commandPool,                // command pool
-            vk::CommandBufferLevel::ePrimary, // command buffer level
-            1,                                // num buffers
-        })[0];
+        frame.commands.Initialize(device, graphicsQueueFamily, numRecordingThreads);
+        mainDeletionQueue.PushBack([&frame]() { frame.commands.Destroy(); }, std::format("command arena F{}", i));
         i++;
     }
 
+    vk::CommandPoolCreateInfo commandPoolInfo = {{vk::CommandPoolCreateFlagBits::eResetCommandBuffer}, graphicsQueueFamily};
 
     immediateCommandPool = device.createCommandPool(commandPoolInfo);
     mainDeletionQueue.PushBack(
@@ -176,10 +243,10 @@ void Application::InitCommands() {
     })[0];
 
 
-    std::cout << "Commands initialized\n";
+    LUMINA_LOG_INFO(General, "Commands initialized");
 }
 void Application::InitSyncObjects() {
-    std::cout << "Initializing sync objects\n";
+    LUMINA_LOG_INFO(General, "Initializing sync objects");
 
     vk::SemaphoreCreateInfo semaphoreInfo = {};
     vk::FenceCreateInfo fenceInfo = {{vk::FenceCreateFlagBits::eSignaled}};
@@ -188,70 +255,116 @@ void Application::InitSyncObjects() {
     for (auto& frame : frames) {
         frame.renderSemaphore = device.createSemaphore(semaphoreInfo);
         frame.swapchainSemaphore = device.createSemaphore(semaphoreInfo);
-        frame.renderFence = device.createFence(fenceInfo);
 
         mainDeletionQueue.PushBack(
             [&, i = i]() {
                 device.destroySemaphore(frame.renderSemaphore);
                 device.destroySemaphore(frame.swapchainSemaphore);
-                device.destroyFence(frame.renderFence);
             },
             std::format("sync objects F{}", i)
         );
         i++;
     }
 
+    vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo> timelineInfo = {
+        {},
+        {vk::SemaphoreType::eTimeline, 0},
+    };
+    frameTimeline = device.createSemaphore(timelineInfo.get<vk::SemaphoreCreateInfo>());
+    mainDeletionQueue.PushBack([&]() { device.destroySemaphore(frameTimeline); }, "frame timeline");
+
     immediateFence = device.createFence(fenceInfo);
     mainDeletionQueue.PushBack([&]() { device.destroyFence(immediateFence); }, "immediate fence");
 
-    std::cout << "Sync objects initialized\n";
+    LUMINA_LOG_INFO(General, "Sync objects initialized");
 }
-void Application::InitDescriptors() {
-    std::cout << "Initializing descriptors\n";
+void Application::InitProfiler() {
+    LUMINA_LOG_INFO(General, "Initializing GPU profiler");
 
-    std::vector<DescriptorAllocator::PoolSizeRatio> sizes = {
-        {vk::DescriptorType::eStorageImage, 1},
-    };
+    gpuProfiler.Initialize(physicalDevice, device, graphicsQueueFamily);
+
+    int i = 0;
+    for (auto& frame : frames) {
+        gpuProfiler.CreateFrameQueries(frame.timestamps);
+        mainDeletionQueue.PushBack(
+            [&]() { gpuProfiler.DestroyFrameQueries(frame.timestamps); },
+            std::format("timestamp queries F{}", i)
+        );
+        i++;
+    }
+
+    LUMINA_LOG_INFO(General, "GPU profiler initialized");
+}
+void Application::InitUploads() {
+    LUMINA_LOG_INFO(General, "Initializing uploads");
+
+    stagingRing.Initialize(*this, stagingBytesPerFrame, static_cast<uint32_t>(frames.size()));
+    mainDeletionQueue.PushBack([&]() { stagingRing.Destroy(); }, "staging ring");
 
-    globalDescriptorAllocator.Initialize(device, 10, sizes);
-    mainDeletionQueue.PushBack([this]() { globalDescriptorAllocator.Destroy(); }, "global descriptor allocator");
+    uploadManager.Initialize(*this, device, transferQueue, transferQueueFamily, graphicsQueueFamily);
+    mainDeletionQueue.PushBack([&]() { uploadManager.Destroy(); }, "upload manager");
 
-    {
-        DescriptorLayoutBuilder builder;
-        builder.AddBinding(0, vk::DescriptorType::eStorageImage);
-        drawImageDescriptorLayout = builder.Build(device, vk::ShaderStageFlagBits::eCompute);
+    if (transferQueueFamily != graphicsQueueFamily) {
+        LUMINA_LOG_INFO(Vulkan, "Using queue family {} for uploads", transferQueueFamily);
     }
 
-    drawImageDescriptors = globalDescriptorAllocator.Allocate(drawImageDescriptorLayout);
+    LUMINA_LOG_INFO(General, "Uploads initialized");
+}
+void Application::InitDescriptors() {
+    LUMINA_LOG_INFO(General, "Initializing descriptors");
 
-    vk::DescriptorImageInfo imgInfo = {
-        {},
-        drawImage,
-        vk::ImageLayout::eGeneral,
+    std::vector<DescriptorAllocator::PoolSizeRatio> frameSizes = {
+        {vk::DescriptorType::eStorageImage,         3},
+        {vk::DescriptorType::eStorageBuffer,        3},
+        {vk::DescriptorType::eUniformBuffer,        3},
+        {vk::DescriptorType::eCombinedImageSampler, 4},
     };
 
-    vk::WriteDescriptorSet drawImageWrite = {
-        drawImageDescriptors,
-        0,
-        0,
-        1,
-        vk::DescriptorType::eStorageImage,
-        &imgInfo,
-    };
+    int i = 0;
+    for (auto& frame : frames) {
+        frame.frameDescriptors.Initialize(device, 1000, frameSizes);
+        mainDeletionQueue.PushBack([&]() { frame.frameDescriptors.Destroy(); }, std::format("frame descriptors F{}", i));
+        i++;
+    }
+
+    bindlessHeap.Initialize(physicalDevice, device);
+    mainDeletionQueue.PushBack([this]() { bindlessHeap.Destroy(); }, "bindless heap");
+
+    drawImageIndex = bindlessHeap.RegisterStorageImage(drawImage);
+    accumulationImageIndex = bindlessHeap.RegisterStorageImage(accumulationImage);
 
-    device.updateDescriptorSets(drawImageWrite, {});
+    deepZoom.Initialize(*this, bindlessHeap, static_cast<uint32_t>(frames.size()));
+    mainDeletionQueue.PushBack([this]() { deepZoom.Destroy(); }, "deep zoom orbits");
 
-    std::cout << "Descriptors initialized\n";
+    LUMINA_LOG_INFO(General, "Descriptors initialized");
 }
 
 
 void Application::InitPipelines() {
-    std::cout << "Initializing pipelines\n";
+    LUMINA_LOG_INFO(General, "Initializing pipelines");
+
+    pipelineCache.Initialize(physicalDevice, device, pipelineCachePath);
+    mainDeletionQueue.PushBack(
+        [&]() {
+            pipelineCache.Save();
+            pipelineCache.Destroy();
+        },
+        "pipeline cache"
+    );
+
+    if (std::filesystem::exists(assetPackPath)) {
+        assetPack.Open(assetPackPath);
+        mainDeletionQueue.PushBack([&]() { assetPack.Close(); }, "asset pack");
+        LUMINA_LOG_INFO(Pipelines, "Mapped asset pack {}", assetPackPath);
+    }
+
+    // pipelines compile on the job system and are only waited for when they are first bound
+    pipelineCompiler.Initialize(device, pipelineCache, jobSystem, assetPack.IsOpen() ? &assetPack : nullptr);
 
     InitBackgroundPipelines();
     InitTrianglePipeline();
 
-    std::cout << "Pipelines initialized\n";
+    LUMINA_LOG_INFO(General, "Pipelines queued for compilation");
 }
 void Application::InitImgui() {
     std::array<vk::DescriptorPoolSize, 11> poolSizes = {
@@ -287,7 +400,15 @@ void Application::InitImgui() {
 
     ImGui::StyleColorsDark();
 
-    ImGui_ImplSDL3_InitForVulkan(window.GetRawWindow());
+    if (IsHeadless()) {
+        io.DisplaySize = ImVec2(static_cast<float>(windowSize.x), static_cast<float>(windowSize.y));
+    }
+    else {
+        ImGui_ImplSDL3_InitForVulkan(window->GetRawWindow());
+    }
+
+    // without a swapchain imgui draws straight into the draw image
+    const vk::Format imguiTargetFormat = IsHeadless() ? drawImage.GetFormat() : swapchainImageFormat;
 
     ImGui_ImplVulkan_InitInfo initInfo = {
         .Instance = instance,
@@ -301,7 +422,7 @@ void Application::InitImgui() {
         .ImageCount = 3,
         .MSAASamples = VK_SAMPLE_COUNT_1_BIT,
         .UseDynamicRendering = true,
-        .PipelineRenderingCreateInfo = vk::PipelineRenderingCreateInfoKHR{{}, swapchainImageFormat},
+        .PipelineRenderingCreateInfo = vk::PipelineRenderingCreateInfoKHR{{}, imguiTargetFormat},
     };
 
     ImGui_ImplVulkan_Init(&initInfo);
@@ -309,7 +430,9 @@ void Application::InitImgui() {
     mainDeletionQueue.PushBack(
         [=, this]() {
             device.destroyDescriptorPool(imguiPool);
-            ImGui_ImplSDL3_Shutdown();
+            if (!IsHeadless()) {
+                ImGui_ImplSDL3_Shutdown();
+            }
             ImGui_ImplVulkan_Shutdown();
             ImGui::DestroyContext();
         },
@@ -319,63 +442,34 @@ void Application::InitImgui() {
 
 
 void Application::InitBackgroundPipelines() {
-    std::cout << "Initializing background pipelines\n";
-
-    vk::PushConstantRange pushConstants = {
-        vk::ShaderStageFlagBits::eCompute,
-        0,
-        sizeof(ComputePushConstants),
-    };
-
-    vk::PipelineLayoutCreateInfo computeLayout = {
-        {},
-        drawImageDescriptorLayout,
-        pushConstants,
-    };
+    LUMINA_LOG_INFO(General, "Initializing background pipelines");
 
-    gradientPipelineLayout = device.createPipelineLayout(computeLayout);
+    static_assert(sizeof(ComputePushConstants) <= BindlessHeap::pushConstantSize);
+    static_assert(sizeof(ResolvePushConstants) <= BindlessHeap::pushConstantSize);
 
-    vk::ShaderModule computeDrawShader = LoadShaderModule("resources/shaders/gradient.comp.spv", device);
+    gradientVariants.Initialize(device, pipelineCompiler, "resources/shaders/gradient.comp.spv", bindlessHeap.GetPipelineLayout());
+    resolveVariants.Initialize(device, pipelineCompiler, "resources/shaders/julia_resolve.comp.spv", bindlessHeap.GetPipelineLayout());
 
-    vk::PipelineShaderStageCreateInfo stageInfo = {
-        {},
-        vk::ShaderStageFlagBits::eCompute,
-        computeDrawShader,
-        "main",
-    };
+    mainDeletionQueue.PushBack([&]() { gradientVariants.Destroy(); }, "gradient pipelines");
+    mainDeletionQueue.PushBack([&]() { resolveVariants.Destroy(); }, "resolve pipelines");
 
-    vk::ComputePipelineCreateInfo computePipelineCreateInfo = {
-        {},
-        stageInfo,
-        gradientPipelineLayout,
-    };
+    // start compiling the shapes that will most likely be used right away
+    workgroupTuner.Initialize(physicalDevice, device, graphicsQueueFamily, workgroupTuningPath);
+    mainDeletionQueue.PushBack([&]() { workgroupTuner.Destroy(); }, "workgroup tuner");
 
-    gradientPipeline = VkCheck(device.createComputePipeline(nullptr, computePipelineCreateInfo));
-
-    device.destroyShaderModule(computeDrawShader);
-
-    mainDeletionQueue.PushBack(
-        [&]() { device.destroyPipelineLayout(gradientPipelineLayout); },
-        "gradient pipeline layout"
-    );
-    mainDeletionQueue.PushBack([&]() { device.destroyPipeline(gradientPipeline); }, "gradient pipeline");
+    gradientShape = workgroupTuner.GetStoredShape("gradient").value_or(WorkgroupTuner::Shape{});
+    resolveShape = workgroupTuner.GetStoredShape("julia_resolve").value_or(WorkgroupTuner::Shape{});
+    gradientVariants.Get(GetWorkgroupConstants(gradientShape));
+    resolveVariants.Get(GetWorkgroupConstants(resolveShape));
 
-    std::cout << "Background pipelines initialized\n";
+    LUMINA_LOG_INFO(General, "Background pipelines queued");
 }
 void Application::InitTrianglePipeline() {
-    std::cout << "Initializing triangle pipeline\n";
-    vk::ShaderModule triangleFragmentShader = LoadShaderModule("resources/shaders/colored_triangle.frag.spv", device);
-    vk::ShaderModule triangleVertexShader = LoadShaderModule("resources/shaders/colored_triangle.vert.spv", device);
+    LUMINA_LOG_INFO(General, "Initializing triangle pipeline");
 
-    vk::PipelineLayoutCreateInfo triangleLayout = {
-        {},
-        drawImageDescriptorLayout,
-    };
-    trianglePipelineLayout = device.createPipelineLayout(triangleLayout);
-
-    PipelineBuilder builder;
-    builder.SetPipelineLayout(trianglePipelineLayout);
-    builder.SetShaders(triangleVertexShader, triangleFragmentShader);
+    // kept around to rebuild the pipeline when its shaders are reloaded
+    PipelineBuilder& builder = trianglePipelineBuilder;
+    builder.SetPipelineLayout(bindlessHeap.GetPipelineLayout());
     builder.SetInputTopology(vk::PrimitiveTopology::eTriangleList);
     builder.SetPolygonMode(vk::PolygonMode::eFill);
     builder.SetCullMode(vk::CullModeFlagBits::eNone, vk::FrontFace::eClockwise);
@@ -385,25 +479,104 @@ void Application::InitTrianglePipeline() {
     builder.SetColorAttachmentFormat(drawImage.GetFormat());
     builder.SetDepthFormat(vk::Format::eUndefined);
 
-    trianglePipeline = builder.Build(device);
-
-    device.destroyShaderModule(triangleFragmentShader);
-    device.destroyShaderModule(triangleVertexShader);
+    trianglePipeline = pipelineCompiler.CompileGraphics(builder, triangleVertexShaderPath, triangleFragmentShaderPath);
 
     mainDeletionQueue.PushBack(
         [&]() {
-            device.destroyPipelineLayout(trianglePipelineLayout);
-            device.destroyPipeline(trianglePipeline);
+            trianglePipeline.Destroy(device);
+            reloadedTrianglePipeline.Destroy(device);
         },
         "triangle pipeline"
     );
-    std::cout << "Triangle pipeline initialized\n";
+    LUMINA_LOG_INFO(General, "Triangle pipeline queued");
+}
+void Application::InitWorkgroupTuning() {
+    bool needsGradient = !workgroupTuner.GetStoredShape("gradient").has_value();
+    bool needsResolve = !workgroupTuner.GetStoredShape("julia_resolve").has_value();
+    if (!isWorkgroupTuningEnabled || (!needsGradient && !needsResolve)) {
+        return;
+    }
+
+    LUMINA_LOG_INFO(General, "Tuning workgroup shapes");
+
+    // all candidates compile in parallel while the first ones are measured
+    for (auto shape : workgroupTuner.GetCandidates()) {
+        gradientVariants.Get(GetWorkgroupConstants(shape));
+        resolveVariants.Get(GetWorkgroupConstants(shape));
+    }
+
+    // a connected Julia set, so the benchmark sees escaping pixels as well as ones running to the limit
+    ComputePushConstants pc;
+    pc.renderSize = glm::vec2(drawImage.GetExtent().width, drawImage.GetExtent().height);
+    pc.accumulationImageIndex = accumulationImageIndex;
+    pc.numSamples = 1;
+
+    deepZoom.SetJuliaParameter({-0.8, 0.156});
+    auto deepZoomParameters = deepZoom.Update(0, pc.renderSize, jobSystem);
+    pc.pixelScale = deepZoomParameters.pixelScale;
+    pc.referenceOffset = deepZoomParameters.referenceOffset;
+    pc.orbitBufferIndex = deepZoomParameters.orbitBufferIndex;
+    pc.referenceLength = deepZoomParameters.referenceLength;
+    pc.criticalOffset = deepZoomParameters.criticalOffset;
+    pc.criticalLength = deepZoomParameters.criticalLength;
+    pc.maxIterations = deepZoomParameters.maxIterations;
+
+    ResolvePushConstants resolvePc;
+    resolvePc.renderSize = pc.renderSize;
+    resolvePc.accumulationImageIndex = accumulationImageIndex;
+    resolvePc.drawImageIndex = drawImageIndex;
+
+    auto submit = [this](std::function<void(vk::CommandBuffer)>&& func) {
+        SubmitImmediately([&](vk::CommandBuffer cmd) {
+            bindlessHeap.Bind(cmd, vk::PipelineBindPoint::eCompute);
+            accumulationImage.TransitionTo(
+                cmd,
+                vk::ImageLayout::eGeneral,
+                vk::PipelineStageFlagBits2::eComputeShader,
+                vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite
+            );
+            drawImage.TransitionTo(
+                cmd, vk::ImageLayout::eGeneral, vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite
+            );
+            func(cmd);
+        });
+    };
+
+    if (needsGradient) {
+        gradientShape = workgroupTuner.Tune("gradient", submit, [&](vk::CommandBuffer cmd, WorkgroupTuner::Shape shape) {
+            RecordJulia(cmd, gradientVariants.Get(GetWorkgroupConstants(shape)), pc, shape);
+        });
+    }
+    if (needsResolve) {
+        resolveShape = workgroupTuner.Tune("julia_resolve", submit, [&](vk::CommandBuffer cmd, WorkgroupTuner::Shape shape) {
+            RecordJuliaResolve(cmd, resolvePc, shape);
+        });
+    }
+
+    workgroupTuner.Save();
+    LUMINA_LOG_INFO(General, "Workgroup shapes tuned");
+}
+void Application::InitShaderHotReload() {
+    if (!isShaderHotReloadEnabled) {
+        return;
+    }
+
+    LUMINA_LOG_INFO(General, "Initializing shader hot reload");
+
+    // the path of the compiler the build used for the shaders
+    shaderHotReload.Initialize(shaderSourceDirectory, LUMINA_GLSLC_PATH, jobSystem);
+    // stops the watcher before the pipelines it reloads are destroyed
+    mainDeletionQueue.PushBack([&]() { shaderHotReload.Destroy(); }, "shader hot reload");
+
+    LUMINA_LOG_INFO(General, "Shader hot reload initialized");
 }
 
 void Application::CreateSwapchain(glm::ivec2 size) {
 
     swapchainImageFormat = vk::Format::eB8G8R8A8Unorm;
 
+    vk::SwapchainKHR oldSwapchain = swapchain;
+
     vkb::SwapchainBuilder builder(physicalDevice, device, surface);
     vkb::Swapchain vkbSwapchain = builder
                                       .set_desired_format(vk::SurfaceFormatKHR{
@@ -413,11 +586,21 @@ void Application::CreateSwapchain(glm::ivec2 size) {
                                       .set_desired_extent(size.x, size.y)
                                       .add_image_usage_flags(static_cast<VkImageUsageFlags>(vk::ImageUsageFlagBits::eTransferDst))
                                       .set_desired_present_mode(static_cast<VkPresentModeKHR>(vk::PresentModeKHR::eFifo))
+                                      .set_old_swapchain(oldSwapchain)
                                       .build()
                                       .value();
     swapchainExtent = vkbSwapchain.extent;
     swapchain = vkbSwapchain.swapchain;
-    mainDeletionQueue.PushBack([&]() { device.destroySwapchainKHR(swapchain); }, "swapchain");
+
+    if (oldSwapchain) {
+        // frames still in flight may use the old images, so they are retired together with this frame
+        for (auto imageView : swapchainImageViews) {
+            retirementQueue.Retire(imageView, GetFrameTimelineValue(), "old swapchain image view");
+        }
+        retirementQueue.Retire(oldSwapchain, GetFrameTimelineValue(), "old swapchain");
+    }
+    swapchainImages.clear();
+    swapchainImageViews.clear();
 
     auto images = vkbSwapchain.get_images().value();
     for (auto* img : images) {
@@ -425,13 +608,107 @@ void Application::CreateSwapchain(glm::ivec2 size) {
     }
 
     auto imageViews = vkbSwapchain.get_image_views().value();
-    int i = 0;
     for (auto* imgView : imageViews) {
         swapchainImageViews.emplace_back(imgView);
-        mainDeletionQueue.PushBack([=, this]() { device.destroyImageView(imgView); }, std::format("image view F{}", i));
-        i++;
     }
 }
+void Application::DestroySwapchain() {
+    for (auto imageView : swapchainImageViews) {
+        device.destroyImageView(imageView);
+    }
+    swapchainImageViews.clear();
+    swapchainImages.clear();
+
+    device.destroySwapchainKHR(swapchain);
+    swapchain = nullptr;
+}
+
+bool Application::RecreateSwapchain() {
+    glm::ivec2 size = window->GetPixelSize();
+    if (size.x <= 0 || size.y <= 0) {
+        return false;
+    }
+
+    CreateSwapchain(size);
+    GrowDrawImage(swapchainExtent);
+
+    isSwapchainOutdated = false;
+    return true;
+}
+
+void Application::AcquireSwapchainImage() {
+    while (true) {
+        if (isSwapchainOutdated && !RecreateSwapchain()) {
+            throw std::runtime_error("Swapchain is out of date and the window has no area to recreate it");
+        }
+
+        try {
+            auto result = device.acquireNextImageKHR(swapchain, UINT64_MAX, GetCurrentFrame().swapchainSemaphore, nullptr);
+            currentSwapchainImageIndex = result.value;
+
+            // a suboptimal image can still be presented, recreate before the next frame
+            if (result.result == vk::Result::eSuboptimalKHR) {
+                isSwapchainOutdated = true;
+            }
+            return;
+        }
+        catch (vk::OutOfDateKHRError const&) {
+            isSwapchainOutdated = true;
+        }
+    }
+}
+
+void Application::CreateDrawImage(vk::Extent2D extent) {
+    vk::Extent3D drawImageExtent = {
+        extent.width,
+        extent.height,
+        1,
+    };
+
+    using enum vk::ImageUsageFlagBits;
+    drawImage = VulkanImage(
+        *this,
+        vk::Format::eR16G16B16A16Sfloat,
+        eTransferSrc | eTransferDst | eStorage | eColorAttachment,
+        drawImageExtent,
+        vk::ImageAspectFlagBits::eColor
+    );
+    accumulationImage = VulkanImage(
+        *this, vk::Format::eR32G32B32A32Sfloat, eStorage, drawImageExtent, vk::ImageAspectFlagBits::eColor
+    );
+}
+
+void Application::GrowDrawImage(vk::Extent2D minExtent) {
+    vk::Extent3D currentExtent = drawImage.GetExtent();
+    if (minExtent.width <= currentExtent.width && minExtent.height <= currentExtent.height) {
+        // smaller swapchains just render into a part of the draw image
+        return;
+    }
+
+    // submitted frames still use the old image and its heap slot, both retire with them
+    drawImage.Retire(retirementQueue, GetFrameTimelineValue(), "old draw image");
+    bindlessHeap.Release(BindlessHeap::Binding::StorageImage, drawImageIndex, GetFrameTimelineValue());
+
+    accumulationImage.Retire(retirementQueue, GetFrameTimelineValue(), "old accumulation image");
+    bindlessHeap.Release(BindlessHeap::Binding::StorageImage, accumulationImageIndex, GetFrameTimelineValue());
+
+    CreateDrawImage({
+        std::max(minExtent.width, currentExtent.width),
+        std::max(minExtent.height, currentExtent.height),
+    });
+    drawImageIndex = bindlessHeap.RegisterStorageImage(drawImage);
+    accumulationImageIndex = bindlessHeap.RegisterStorageImage(accumulationImage);
+    progressiveAccumulation.Reset();
+}
+
+void Application::WaitForFrameValue(uint64_t value) {
+    if (value == 0) {
+        return;
+    }
+
+    vk::SemaphoreWaitInfo waitInfo = {{}, frameTimeline, value};
+    VkCheck(device.waitSemaphores(waitInfo, UINT64_MAX));
+}
 
 void Application::SubmitImmediately(std::function<void(vk::CommandBuffer)>&& func) {
     device.resetFences(immediateFence);
@@ -464,10 +741,33 @@ VKAPI_ATTR VkBool32 VKAPI_CALL Application::VulkanDebugCallback(
     const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
     void* userData
 ) {
-    std::string severity = vk::to_string(static_cast<vk::DebugUtilsMessageSeverityFlagBitsEXT>(messageSeverity));
-    std::string type = vk::to_string(static_cast<vk::DebugUtilsMessageTypeFlagBitsEXT>(messageType));
+    // called on driver threads too, so this only copies the message, the logger thread does the rest
+    LogLevel level = LogLevel::Trace;
+    switch (static_cast<vk::DebugUtilsMessageSeverityFlagBitsEXT>(messageSeverity)) {
+    case vk::DebugUtilsMessageSeverityFlagBitsEXT::eError:
+        level = LogLevel::Error;
+        break;
+    case vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning:
+        level = LogLevel::Warning;
+        break;
+    case vk::DebugUtilsMessageSeverityFlagBitsEXT::eInfo:
+        level = LogLevel::Debug;
+        break;
+    default:
+        break;
+    }
 
-    std::cout << std::format("[{}: {}] {}\n", severity, type, pCallbackData->pMessage);
+    std::string_view type = "general";
+    if ((messageType & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT) != 0) {
+        type = "validation";
+    }
+    else if ((messageType & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT) != 0) {
+        type = "performance";
+    }
+
+    if (static_cast<int>(level) >= LUMINA_LOG_LEVEL) {
+        Log::Write(level, LogCategory::Vulkan, "[{}] {}", type, pCallbackData->pMessage);
+    }
 
     return vk::False; // Applications must return false here
 }
@@ -483,15 +783,30 @@ void Application::Run() {
     isRunning = true;
     double dt = 1.0f / 60.0f;
 
+    if (isTickThreadEnabled) {
+        StartTickThread();
+    }
+    // Tick() is virtual, so the thread has to stop before an exception unwinds into the derived destructors
+    ScopeGuard tickThreadGuard([this]() { StopTickThread(); });
+
     auto lastFrame = std::chrono::high_resolution_clock::now();
     while (isRunning) {
-        while (auto e = window.GetEvent()) {
-            HandleEvent(e.value());
+        if (!IsHeadless()) {
+            while (auto e = window->GetEvent()) {
+                HandleEvent(e.value());
+            }
         }
 
-        Tick(dt);
+        if (!isTickThreadEnabled) {
+            Tick(dt);
+            jobSystem.Wait(tickJobs);
+        }
 
-        if (!isRenderingEnabled) {
+        // a zero sized window can't have a swapchain, wait until it gets an area again
+        bool hasNoArea = !IsHeadless() && isSwapchainOutdated
+                      && glm::any(glm::lessThanEqual(window->GetPixelSize(), glm::ivec2(0)));
+
+        if (!isRenderingEnabled || hasNoArea) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
             continue;
         }
@@ -511,17 +826,93 @@ void Application::Exit() {
     isRunning = false;
 }
 
+void Application::StartTickThread() {
+    numTicks = 0;
+    tickEpoch = std::chrono::steady_clock::now().time_since_epoch().count();
+    isTickThreadRunning = true;
+    tickThread = std::thread([this]() { TickLoop(); });
 
-void Application::Tick(float dt) {}
+    LUMINA_LOG_INFO(General, "Ticking at {} Hz on a separate thread", tickRate);
+}
+void Application::StopTickThread() {
+    isTickThreadRunning = false;
+    if (tickThread.joinable()) {
+        tickThread.join();
+    }
+}
 
-void Application::PreRender(float dt) {
-    VkCheck(device.waitForFences(GetCurrentFrame().renderFence, vk::True, UINT64_MAX));
-    GetCurrentFrame().deletionQueue.Flush();
+void Application::TickLoop() {
+    const auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / tickRate));
+    const auto dt = static_cast<float>(1.0 / tickRate);
+
+    auto epoch = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(tickEpoch.load()));
+    // tick N simulates up to (N + 1) * step, so it runs once that time has come
+    auto nextTick = epoch + step;
+
+    while (isTickThreadRunning) {
+        std::this_thread::sleep_until(nextTick);
+
+        uint32_t numCatchUpTicks = 0;
+        while (isTickThreadRunning && std::chrono::steady_clock::now() >= nextTick && numCatchUpTicks < maxCatchUpTicks) {
+            Tick(dt);
+            jobSystem.Wait(tickJobs);
+
+            numTicks.fetch_add(1, std::memory_order_release);
+            nextTick += step;
+            numCatchUpTicks++;
+        }
+
+        // Ticks take longer than they simulate, catching up would only make it worse. The ticks are dropped,
+        // which slows the simulation down but keeps it deterministic.
+        auto now = std::chrono::steady_clock::now();
+        if (numCatchUpTicks == maxCatchUpTicks && now >= nextTick) {
+            auto numSkipped = (now - nextTick) / step + 1;
+            nextTick += numSkipped * step;
+            epoch += numSkipped * step;
+            tickEpoch.store(epoch.time_since_epoch().count(), std::memory_order_relaxed);
+            LUMINA_LOG_WARNING(General, "Tick can't keep up with {} Hz, skipped {} ticks", tickRate, numSkipped);
+        }
+    }
+}
+
+float Application::GetTickAlpha(uint64_t tickIndex) const {
+    auto epoch = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(tickEpoch.load(std::memory_order_relaxed)));
+    double ticksSinceEpoch = std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count() * tickRate;
 
-    device.resetFences(GetCurrentFrame().renderFence);
+    // tick N ends at N + 1
+    return std::clamp(static_cast<float>(ticksSinceEpoch - static_cast<double>(tickIndex + 1)), 0.0f, 1.0f);
+}
+
+
+void Application::Tick(float dt) {
+    if (!isTickThreadEnabled) {
+        if (isJuliaAnimated) {
+            juliaTime += dt;
+        }
+        return;
+    }
 
-    currentSwapchainImageIndex =
-        device.acquireNextImageKHR(swapchain, UINT64_MAX, GetCurrentFrame().swapchainSemaphore, nullptr).value;
+    float previousTime = tickJuliaTime;
+    if (isJuliaAnimated) {
+        tickJuliaTime += dt;
+    }
+    juliaTickStates.GetWriteBuffer() = {GetTickIndex(), previousTime, tickJuliaTime};
+    juliaTickStates.Publish();
+}
+
+void Application::PreRender(float dt) {
+    // wait until the last frame using this slot is done on the GPU
+    if (currentFrame >= frames.size()) {
+        WaitForFrameValue(GetFrameTimelineValue() - frames.size());
+    }
+    retirementQueue.Collect(GetCompletedFrameValue());
+    GetCurrentFrame().commands.Reset();
+    GetCurrentFrame().mainCommandBuffer = GetCurrentFrame().commands.AllocatePrimary(0);
+    GetCurrentFrame().frameDescriptors.Reset();
+    bindlessHeap.CollectRetired(GetCompletedFrameValue());
+    stagingRing.BeginFrame(static_cast<uint32_t>(currentFrame % frames.size()));
+    uploadManager.CollectCompleted();
+    SwapReloadedPipelines();
 
     auto drawImageExtent = drawImage.GetExtent();
     drawExtent = vk::Extent2D{
@@ -529,13 +920,42 @@ void Application::PreRender(float dt) {
         drawImageExtent.height,
     };
 
+    if (!IsHeadless()) {
+        // may recreate the swapchain, which has to happen after the flush above so the old one outlives its frames
+        AcquireSwapchainImage();
+
+        drawImageExtent = drawImage.GetExtent();
+        drawExtent = vk::Extent2D{
+            std::min(swapchainExtent.width, drawImageExtent.width),
+            std::min(swapchainExtent.height, drawImageExtent.height),
+        };
+    }
+
     vk::CommandBuffer cmd = GetCurrentFrame().mainCommandBuffer;
-    cmd.reset();
     cmd.begin({{vk::CommandBufferUsageFlagBits::eOneTimeSubmit}});
 
-    VulkanImage::Transition(cmd, drawImage, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral);
+    // reads the timestamps this frame slot recorded `frames.size()` frames ago
+    gpuProfiler.BeginFrame(cmd, GetCurrentFrame().timestamps);
+
+    bindlessHeap.Bind(cmd, vk::PipelineBindPoint::eCompute);
+    bindlessHeap.Bind(cmd, vk::PipelineBindPoint::eGraphics);
 
-    ImGui_ImplSDL3_NewFrame();
+    // render into a part of the draw image, the blit scales it back up to the swapchain
+    dynamicResolution.Update(gpuProfiler.GetLastFrameTime());
+    drawExtent = dynamicResolution.GetRenderExtent(drawExtent);
+
+    // the draw image keeps its contents and state across frames, the first pass only waits for the last use
+    renderGraph.Reset();
+    drawImageResource = renderGraph.ImportImage("draw image", drawImage);
+
+    if (IsHeadless()) {
+        ImGuiIO& io = ImGui::GetIO();
+        io.DisplaySize = ImVec2(static_cast<float>(drawExtent.width), static_cast<float>(drawExtent.height));
+        io.DeltaTime = dt > 0 ? dt : 1.0f / 60.0f;
+    }
+    else {
+        ImGui_ImplSDL3_NewFrame();
+    }
     ImGui_ImplVulkan_NewFrame();
     ImGui::NewFrame();
 }
@@ -543,90 +963,313 @@ void Application::PreRender(float dt) {
 void Application::Render(float dt) {
     vk::CommandBuffer cmd = GetCurrentFrame().mainCommandBuffer;
 
-    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, gradientPipeline);
-    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, gradientPipelineLayout, 0, drawImageDescriptors, {});
+    // recorded before any pass of the graph
+    stagingRing.FlushBarrier(cmd);
 
-    static ComputePushConstants pc;
-    pc.color1 = glm::vec4(glm::rgbColor(glm::hsvColor(pc.color1.xyz()) + glm::vec3(dt * 10, 0, 0)), 1.0);
+    juliaColor = glm::vec4(glm::rgbColor(glm::hsvColor(juliaColor.xyz()) + glm::vec3(dt * 10, 0, 0)), 1.0);
 
-    const float minAxis = glm::min(windowSize.x, windowSize.y);
-    pc.samplePoint = glm::vec2(windowSize) / 2.0f
-                   + glm::vec2(minAxis, minAxis) / 4.0f * glm::vec2(std::cos(time), std::sin(time));
+    if (isTickThreadEnabled) {
+        juliaTickStates.Update();
+        auto const& state = juliaTickStates.GetReadBuffer();
+        juliaTime = glm::mix(state.previousTime, state.time, GetTickAlpha(state.tickIndex));
+    }
+
+    ComputePushConstants pc;
+    pc.renderSize = glm::vec2(drawExtent.width, drawExtent.height);
+    pc.accumulationImageIndex = accumulationImageIndex;
+
+    // c circles at a quarter of the smaller axis around the center, in the units of the unzoomed view
+    const float minAxis = glm::min(pc.renderSize.x, pc.renderSize.y);
+    const float maxAxis = glm::max(pc.renderSize.x, pc.renderSize.y);
+    deepZoom.SetJuliaParameter(pinnedJuliaParameter.value_or(
+        glm::dvec2(std::cos(juliaTime), std::sin(juliaTime)) * double(minAxis / maxAxis)
+    ));
+
+    auto deepZoomParameters = deepZoom.Update(
+        static_cast<uint32_t>(currentFrame % frames.size()), pc.renderSize, jobSystem
+    );
+    pc.pixelScale = deepZoomParameters.pixelScale;
+    pc.referenceOffset = deepZoomParameters.referenceOffset;
+    pc.orbitBufferIndex = deepZoomParameters.orbitBufferIndex;
+    pc.referenceLength = deepZoomParameters.referenceLength;
+    pc.criticalOffset = deepZoomParameters.criticalOffset;
+    pc.criticalLength = deepZoomParameters.criticalLength;
+    pc.maxIterations = deepZoomParameters.maxIterations;
 
     ImGui::Begin("Shader Settings");
     ImGui::Text("Time: %f", time);
     ImGui::Text("dT: %f", dt);
-    ImGui::ColorEdit3("Color 1", glm::value_ptr(pc.color1));
+    ImGui::ColorEdit3("Color 1", glm::value_ptr(juliaColor));
+    bool isAnimated = isJuliaAnimated;
+    if (ImGui::Checkbox("Animate", &isAnimated)) {
+        isJuliaAnimated = isAnimated;
+    }
+    int numBatches = static_cast<int>(numJuliaBatches);
+    if (ImGui::SliderInt("Batches", &numBatches, 1, 16)) {
+        numJuliaBatches = static_cast<uint32_t>(numBatches);
+    }
     ImGui::End();
 
-    cmd.pushConstants(gradientPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(pc), &pc);
-    cmd.dispatch(std::ceil(drawExtent.width / 16.0), std::ceil(drawExtent.height / 16.0), 1);
+    // only the inputs of the fractal itself invalidate the samples, the color is applied when resolving
+    const bool inputsChanged = deepZoom.GetVersion() != lastDeepZoomVersion
+                            || pc.renderSize != lastJuliaInputs.renderSize
+                            || pc.accumulationImageIndex != lastJuliaInputs.accumulationImageIndex;
+    lastJuliaInputs = pc;
+    lastDeepZoomVersion = deepZoom.GetVersion();
 
+    const RenderGraph::Usage accumulationWrite = {
+        vk::PipelineStageFlagBits2::eComputeShader,
+        vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite,
+        vk::ImageLayout::eGeneral,
+    };
+    auto accumulationImageResource = renderGraph.ImportImage("accumulation image", accumulationImage);
+
+    if (isJuliaEnabled) {
+        // a converged image doesn't get a dispatch at all
+        auto step = progressiveAccumulation.Advance(inputsChanged);
+        if (step.needsDispatch) {
+            pc.sampleIndex = step.sampleIndex;
+            pc.numSamples = step.numSamples;
+            pc.previewScale = step.previewScale;
+
+            renderGraph.AddPass("gradient")
+                .Read(accumulationImageResource, accumulationWrite)
+                .Write(accumulationImageResource, accumulationWrite)
+                .SetExecute([this, pushConstants = pc](vk::CommandBuffer cmd) {
+                    // the variant cache isn't thread safe, the batches only get the pipeline
+                    vk::Pipeline pipeline = gradientVariants.Get(GetWorkgroupConstants(gradientShape));
+                    if (numJuliaBatches <= 1) {
+                        RecordJulia(cmd, pipeline, pushConstants, gradientShape);
+                        return;
+                    }
+                    RecordComputeBatches(cmd, numJuliaBatches, [&](vk::CommandBuffer batchCmd, uint32_t batch) {
+                        RecordJulia(batchCmd, pipeline, pushConstants, gradientShape, batch, numJuliaBatches);
+                    });
+                });
+        }
 
-    VulkanImage::Transition(cmd, drawImage, vk::ImageLayout::eGeneral, vk::ImageLayout::eColorAttachmentOptimal);
+        ResolvePushConstants resolvePc;
+        resolvePc.color1 = juliaColor;
+        resolvePc.renderSize = pc.renderSize;
+        resolvePc.accumulationImageIndex = accumulationImageIndex;
+        resolvePc.drawImageIndex = drawImageIndex;
+
+        renderGraph.AddPass("resolve")
+            .Read(
+                accumulationImageResource,
+                {vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead, vk::ImageLayout::eGeneral}
+            )
+            .Write(
+                drawImageResource,
+                {vk::PipelineStageFlagBits2::eComputeShader,
+                 vk::AccessFlagBits2::eShaderStorageWrite,
+                 vk::ImageLayout::eGeneral}
+            )
+            .SetExecute([this, pushConstants = resolvePc](vk::CommandBuffer cmd) {
+                RecordJuliaResolve(cmd, pushConstants, resolveShape);
+            });
+    }
 
-    vk::RenderingAttachmentInfo colorAttachment = {
-        drawImage,
-        vk::ImageLayout::eGeneral,
-        vk::ResolveModeFlagBits::eNone,
-        {},
-        vk::ImageLayout::eGeneral,
-        vk::AttachmentLoadOp::eLoad,
-        vk::AttachmentStoreOp::eStore,
+    const RenderGraph::Usage colorAttachmentUsage = {
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite,
+        vk::ImageLayout::eColorAttachmentOptimal,
     };
 
-    vk::RenderingInfo renderInfo = CreateRenderingInfo(drawExtent, colorAttachment, nullptr);
-    cmd.beginRendering(renderInfo);
+    if (!isTriangleEnabled) {
+        return;
+    }
 
-    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, trianglePipeline);
+    renderGraph.AddPass("triangle")
+        .Read(drawImageResource, colorAttachmentUsage)
+        .Write(drawImageResource, colorAttachmentUsage)
+        .SetExecute([this](vk::CommandBuffer cmd) {
+            vk::RenderingAttachmentInfo colorAttachment = {
+                drawImage,
+                vk::ImageLayout::eColorAttachmentOptimal,
+                vk::ResolveModeFlagBits::eNone,
+                {},
+                vk::ImageLayout::eUndefined,
+                vk::AttachmentLoadOp::eLoad,
+                vk::AttachmentStoreOp::eStore,
+            };
+
+            vk::RenderingInfo renderInfo = CreateRenderingInfo(drawExtent, colorAttachment, nullptr);
+            cmd.beginRendering(renderInfo);
+
+            cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, trianglePipeline);
+
+            vk::Viewport viewport = {
+                0,
+                0,
+                static_cast<float>(drawExtent.width),
+                static_cast<float>(drawExtent.height),
+                0.0f,
+                1.0f,
+            };
+
+            cmd.setViewport(0, viewport);
+
+            vk::Rect2D scissor = {
+                {0, 0},
+                drawExtent,
+            };
+
+            cmd.setScissor(0, scissor);
+
+            cmd.draw(3, 1, 0, 0);
+            cmd.endRendering();
+        });
+}
 
-    vk::Viewport viewport = {
-        0,
-        0,
-        static_cast<float>(drawExtent.width),
-        static_cast<float>(drawExtent.height),
-        0.0f,
-        1.0f,
-    };
+void Application::SwapReloadedPipelines() {
+    for (auto const& shaderPath : shaderHotReload.TakeRecompiledShaders()) {
+        // the pack still holds the SPIR-V from the build
+        pipelineCompiler.BypassAssetPack(shaderPath);
 
-    cmd.setViewport(0, viewport);
+        if (shaderPath == gradientVariants.GetShaderPath()) {
+            gradientVariants.Reload();
+        }
+        else if (shaderPath == resolveVariants.GetShaderPath()) {
+            resolveVariants.Reload();
+        }
+        else if (shaderPath == triangleVertexShaderPath || shaderPath == triangleFragmentShaderPath) {
+            reloadedTrianglePipeline.Destroy(device);
+            reloadedTrianglePipeline = pipelineCompiler.CompileGraphics(
+                trianglePipelineBuilder, triangleVertexShaderPath, triangleFragmentShaderPath
+            );
+        }
+    }
 
-    vk::Rect2D scissor = {
-        {0, 0},
-        drawExtent,
-    };
+    // earlier frames may still use the old pipelines
+    if (gradientVariants.SwapReloaded(retirementQueue, GetFrameTimelineValue())) {
+        // a converged image isn't dispatched anymore, so the new shader would never show up
+        progressiveAccumulation.Reset();
+    }
+    resolveVariants.SwapReloaded(retirementQueue, GetFrameTimelineValue());
 
-    cmd.setScissor(0, scissor);
+    if (reloadedTrianglePipeline.IsReady()) {
+        if (!reloadedTrianglePipeline.HasFailed()) {
+            trianglePipeline.Retire(retirementQueue, GetFrameTimelineValue(), "reloaded triangle pipeline");
+            trianglePipeline = reloadedTrianglePipeline;
+        }
+        reloadedTrianglePipeline = {};
+    }
+}
 
-    cmd.draw(3, 1, 0, 0);
-    cmd.endRendering();
+void Application::RecordJulia(
+    vk::CommandBuffer cmd,
+    vk::Pipeline pipeline,
+    ComputePushConstants const& pushConstants,
+    WorkgroupTuner::Shape shape,
+    uint32_t batch,
+    uint32_t numBatches
+) {
+    // every invocation covers a block of previewScale² pixels
+    glm::uvec2 pixelsPerGroup = glm::uvec2(shape.x, shape.y) * pushConstants.previewScale;
+    glm::uvec2 numGroups = (glm::uvec2(pushConstants.renderSize) + pixelsPerGroup - 1u) / pixelsPerGroup;
+
+    const uint32_t firstRow = numGroups.y * batch / numBatches;
+    const uint32_t endRow = numGroups.y * (batch + 1) / numBatches;
+    if (firstRow == endRow) {
+        return;
+    }
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+    cmd.pushConstants(bindlessHeap.GetPipelineLayout(), vk::ShaderStageFlagBits::eAll, 0, sizeof(pushConstants), &pushConstants);
+
+    // the base offsets gl_WorkGroupID, so the shader doesn't know it only covers a band
+    cmd.dispatchBase(0, firstRow, 0, numGroups.x, endRow - firstRow, 1);
+}
+void Application::RecordJuliaResolve(vk::CommandBuffer cmd, ResolvePushConstants const& pushConstants, WorkgroupTuner::Shape shape) {
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, resolveVariants.Get(GetWorkgroupConstants(shape)));
+    cmd.pushConstants(bindlessHeap.GetPipelineLayout(), vk::ShaderStageFlagBits::eAll, 0, sizeof(pushConstants), &pushConstants);
+
+    glm::uvec2 numGroups = (glm::uvec2(pushConstants.renderSize) + glm::uvec2(shape.x, shape.y) - 1u) / glm::uvec2(shape.x, shape.y);
+    cmd.dispatch(numGroups.x, numGroups.y, 1);
 }
 
 void Application::PostRender(float dt) {
     vk::CommandBuffer cmd = GetCurrentFrame().mainCommandBuffer;
 
-    auto& currentImage = swapchainImages[currentSwapchainImageIndex];
-    auto& currentImageView = swapchainImageViews[currentSwapchainImageIndex];
+    gpuProfiler.DrawImGui();
+    dynamicResolution.DrawImGui();
+    progressiveAccumulation.DrawImGui();
+    deepZoom.DrawImGui();
 
-    VulkanImage::Transition(cmd, drawImage, vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::eTransferSrcOptimal);
-    VulkanImage::Transition(cmd, currentImage, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
+    const RenderGraph::Usage colorAttachmentUsage = {
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite,
+        vk::ImageLayout::eColorAttachmentOptimal,
+    };
 
-    VulkanImage::Blit(cmd, drawImage, currentImage, drawExtent, swapchainExtent);
+    if (IsHeadless()) {
+        // the frame ends at the draw image, there is nothing to acquire or present
+        if (isImGuiEnabled) {
+            renderGraph.AddPass("imgui")
+                .Read(drawImageResource, colorAttachmentUsage)
+                .Write(drawImageResource, colorAttachmentUsage)
+                .SetExecute([this](vk::CommandBuffer cmd) { RenderImGui(cmd, drawImage, drawExtent); });
+        }
+        else {
+            ImGui::EndFrame();
+        }
+        renderGraph.SetOutput(drawImageResource);
 
-    VulkanImage::Transition(cmd, currentImage, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eColorAttachmentOptimal);
-    RenderImGui(cmd, currentImageView);
-    VulkanImage::Transition(cmd, currentImage, vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::ePresentSrcKHR);
+        renderGraph.Execute(cmd, gpuProfiler);
+        cmd.end();
 
-    cmd.end();
+        SubmitFrame(cmd);
+        currentFrame++;
+        return;
+    }
 
-    vk::CommandBufferSubmitInfo submitInfo = {cmd};
+    // the acquire semaphore is waited for at eColorAttachmentOutput, so the first barrier has to start there
+    auto swapchainImageResource = renderGraph.ImportImage(
+        "swapchain image",
+        swapchainImages[currentSwapchainImageIndex],
+        vk::ImageAspectFlagBits::eColor,
+        {vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eNone, vk::ImageLayout::eUndefined}
+    );
 
-    vk::SemaphoreSubmitInfo waitInfo = {GetCurrentFrame().swapchainSemaphore, 1, vk::PipelineStageFlagBits2KHR::eColorAttachmentOutput};
-    vk::SemaphoreSubmitInfo signalInfo = {GetCurrentFrame().renderSemaphore, 1, vk::PipelineStageFlagBits2KHR::eAllGraphics};
+    renderGraph.AddPass("blit")
+        .Read(
+            drawImageResource,
+            {vk::PipelineStageFlagBits2::eBlit, vk::AccessFlagBits2::eTransferRead, vk::ImageLayout::eTransferSrcOptimal}
+        )
+        .Write(
+            swapchainImageResource,
+            {vk::PipelineStageFlagBits2::eBlit, vk::AccessFlagBits2::eTransferWrite, vk::ImageLayout::eTransferDstOptimal}
+        )
+        .SetExecute([this](vk::CommandBuffer cmd) {
+            VulkanImage::Blit(cmd, drawImage, swapchainImages[currentSwapchainImageIndex], drawExtent, swapchainExtent);
+        });
+
+    if (isImGuiEnabled) {
+        renderGraph.AddPass("imgui")
+            .Read(swapchainImageResource, colorAttachmentUsage)
+            .Write(swapchainImageResource, colorAttachmentUsage)
+            .SetExecute([this](vk::CommandBuffer cmd) {
+                RenderImGui(cmd, swapchainImageViews[currentSwapchainImageIndex], swapchainExtent);
+            });
+    }
+    else {
+        ImGui::EndFrame();
+    }
 
-    vk::SubmitInfo2 submit = {{}, waitInfo, submitInfo, signalInfo};
+    renderGraph.SetOutput(
+        swapchainImageResource,
+        RenderGraph::Usage{
+            vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+            vk::AccessFlagBits2::eNone,
+            vk::ImageLayout::ePresentSrcKHR,
+        }
+    );
 
-    graphicsQueue.submit2(submit, GetCurrentFrame().renderFence);
+    renderGraph.Execute(cmd, gpuProfiler);
+    cmd.end();
+
+    SubmitFrame(cmd);
 
     vk::PresentInfoKHR presentInfo = {
         GetCurrentFrame().renderSemaphore,
@@ -634,23 +1277,140 @@ void Application::PostRender(float dt) {
         currentSwapchainImageIndex,
     };
 
-    VkCheck(graphicsQueue.presentKHR(presentInfo));
+    try {
+        if (graphicsQueue.presentKHR(presentInfo) == vk::Result::eSuboptimalKHR) {
+            isSwapchainOutdated = true;
+        }
+    }
+    catch (vk::OutOfDateKHRError const&) {
+        isSwapchainOutdated = true;
+    }
     currentFrame++;
 }
 
-void Application::RenderImGui(vk::CommandBuffer cmd, vk::ImageView targetView) {
+void Application::SubmitFrame(vk::CommandBuffer cmd) {
+    vk::CommandBufferSubmitInfo submitInfo = {cmd};
+
+    std::vector<vk::SemaphoreSubmitInfo> waitInfos = std::move(pendingUploadWaits);
+    pendingUploadWaits.clear();
+    std::vector<vk::SemaphoreSubmitInfo> signalInfos = {
+        {frameTimeline, GetFrameTimelineValue(), vk::PipelineStageFlagBits2::eAllCommands},
+    };
+
+    if (!IsHeadless()) {
+        waitInfos.emplace_back(GetCurrentFrame().swapchainSemaphore, 1, vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+        signalInfos.emplace_back(GetCurrentFrame().renderSemaphore, 1, vk::PipelineStageFlagBits2::eAllGraphics);
+    }
+
+    vk::SubmitInfo2 submit = {{}, waitInfos, submitInfo, signalInfos};
+
+    graphicsQueue.submit2(submit);
+}
+
+void Application::WaitForUpload(UploadToken token) {
+    if (token.value == 0) {
+        return;
+    }
+    pendingUploadWaits.push_back(uploadManager.Acquire(GetCurrentCommandBuffer(), token));
+}
+
+vk::CommandBuffer Application::GetCurrentCommandBuffer() {
+    return GetCurrentFrame().mainCommandBuffer;
+}
+
+void Application::RecordRenderingBatches(
+    vk::CommandBuffer cmd,
+    std::span<const vk::Format> colorFormats,
+    vk::Format depthFormat,
+    uint32_t numBatches,
+    BatchFunction const& record
+) {
+    vk::CommandBufferInheritanceRenderingInfo renderingInfo = {
+        {},                                         // flags
+        0,                                          // view mask
+        static_cast<uint32_t>(colorFormats.size()), // num color attachments
+        colorFormats.data(),                        // color attachment formats
+        depthFormat,                                // depth attachment format
+        vk::Format::eUndefined,                     // stencil attachment format
+        vk::SampleCountFlagBits::e1,                // rasterization samples
+    };
+    // dynamic rendering has no render pass or framebuffer to inherit, the formats are all there is
+    vk::CommandBufferInheritanceInfo inheritanceInfo = {};
+    inheritanceInfo.pNext = &renderingInfo;
+
+    vk::CommandBufferBeginInfo beginInfo = {
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue, // flags
+        &inheritanceInfo,                                                                                     // inheritance info
+    };
+    RecordBatches(cmd, beginInfo, vk::PipelineBindPoint::eGraphics, numBatches, record);
+}
+
+void Application::RecordComputeBatches(vk::CommandBuffer cmd, uint32_t numBatches, BatchFunction const& record) {
+    vk::CommandBufferInheritanceInfo inheritanceInfo = {};
+    vk::CommandBufferBeginInfo beginInfo = {
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit, // flags
+        &inheritanceInfo,                               // inheritance info
+    };
+    RecordBatches(cmd, beginInfo, vk::PipelineBindPoint::eCompute, numBatches, record);
+}
+
+void Application::RecordBatches(
+    vk::CommandBuffer cmd,
+    vk::CommandBufferBeginInfo const& beginInfo,
+    vk::PipelineBindPoint bindPoint,
+    uint32_t numBatches,
+    BatchFunction const& record
+) {
+    if (numBatches == 0) {
+        return;
+    }
+
+    CommandArena& arena = GetCurrentFrame().commands;
+    std::vector<vk::CommandBuffer> batches(numBatches);
+
+    // the frame thread works on batches too while it waits, with its own pool
+    jobSystem.ParallelFor(numBatches, [&](uint32_t batch) {
+        vk::CommandBuffer batchCmd = arena.AllocateSecondary(GetRecordingThreadIndex());
+        batchCmd.begin(beginInfo);
+        bindlessHeap.Bind(batchCmd, bindPoint);
+        record(batchCmd, batch);
+        batchCmd.end();
+        batches[batch] = batchCmd;
+    });
+
+    // in batch order, no matter which thread recorded which batch
+    cmd.executeCommands(batches);
+}
+
+uint32_t Application::GetRecordingThreadIndex() const {
+    auto worker = jobSystem.GetCurrentWorkerIndex();
+    if (worker.has_value()) {
+        return worker.value() + 2;
+    }
+    return std::this_thread::get_id() == tickThread.get_id() ? 1 : 0;
+}
+
+DescriptorAllocator& Application::GetFrameDescriptorAllocator() {
+    return GetCurrentFrame().frameDescriptors;
+}
+
+uint64_t Application::GetCompletedFrameValue() const {
+    return device.getSemaphoreCounterValue(frameTimeline);
+}
+
+void Application::RenderImGui(vk::CommandBuffer cmd, vk::ImageView targetView, vk::Extent2D targetExtent) {
     ImGui::Render();
 
     vk::RenderingAttachmentInfo colorAttachment = {
         targetView,
-        vk::ImageLayout::eGeneral,
+        vk::ImageLayout::eColorAttachmentOptimal,
         vk::ResolveModeFlagBits::eNone,
         {},
         vk::ImageLayout::eUndefined,
         vk::AttachmentLoadOp::eLoad,
         vk::AttachmentStoreOp::eStore,
     };
-    vk::RenderingInfo renderInfo = CreateRenderingInfo(swapchainExtent, colorAttachment, nullptr);
+    vk::RenderingInfo renderInfo = CreateRenderingInfo(targetExtent, colorAttachment, nullptr);
 
     cmd.beginRendering(renderInfo);
     ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
@@ -664,6 +1424,15 @@ void Application::HandleEvent(SDL_Event e) {
         case SDL_EventType::SDL_EVENT_QUIT:             Exit(); break;
         case SDL_EventType::SDL_EVENT_WINDOW_MINIMIZED: isRenderingEnabled = false; break;
         case SDL_EventType::SDL_EVENT_WINDOW_RESTORED:  isRenderingEnabled = true; break;
+        case SDL_EventType::SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED: isSwapchainOutdated = true; break;
+        case SDL_EventType::SDL_EVENT_MOUSE_WHEEL:
+            if (window && !ImGui::GetIO().WantCaptureMouse) {
+                // the draw extent is stretched over the whole window, so the cursor maps into it linearly
+                glm::dvec2 renderSize = {drawExtent.width, drawExtent.height};
+                glm::dvec2 cursor = glm::dvec2(e.wheel.mouse_x, e.wheel.mouse_y) / glm::dvec2(window->GetSize()) - 0.5;
+                deepZoom.ZoomAt(cursor * renderSize * deepZoom.GetPixelScale(glm::vec2(renderSize)), std::pow(1.25, e.wheel.y));
+            }
+            break;
     }
 }
 }
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "Lumina/Essence/BindlessHeap.hpp"
+#include "Lumina/Essence/VulkanImage.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace Lumina::Essence {
+
+BindlessHeap::SlotAllocator::SlotAllocator(uint32_t capacity)
+    : capacity(capacity) {}
+
+uint32_t BindlessHeap::SlotAllocator::Allocate() {
+    if (!freeSlots.empty()) {
+        uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+    if (nextUnused >= capacity) {
+        throw std::runtime_error(std::format("Bindless heap is full ({} slots)", capacity));
+    }
+    return nextUnused++;
+}
+void BindlessHeap::SlotAllocator::Release(uint32_t slot, uint64_t retireValue) {
+    retiredSlots.emplace_back(retireValue, slot);
+}
+void BindlessHeap::SlotAllocator::CollectRetired(uint64_t completedValue) {
+    while (!retiredSlots.empty() && retiredSlots.front().first <= completedValue) {
+        freeSlots.push_back(retiredSlots.front().second);
+        retiredSlots.pop_front();
+    }
+}
+
+
+void BindlessHeap::Initialize(vk::PhysicalDevice physicalDevice, vk::Device device) {
+    this->device = device;
+
+    auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+    auto const& limits = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+
+    std::array<uint32_t, numBindings> capacities = {
+        std::min({1024u, limits.maxDescriptorSetUpdateAfterBindStorageImages, limits.maxPerStageDescriptorUpdateAfterBindStorageImages}),
+        std::min({4096u, limits.maxDescriptorSetUpdateAfterBindSampledImages, limits.maxPerStageDescriptorUpdateAfterBindSampledImages}),
+        std::min({256u, limits.maxDescriptorSetUpdateAfterBindSamplers, limits.maxPerStageDescriptorUpdateAfterBindSamplers}),
+        std::min({4096u, limits.maxDescriptorSetUpdateAfterBindStorageBuffers, limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers}),
+    };
+
+    std::array<vk::DescriptorSetLayoutBinding, numBindings> bindings;
+    std::array<vk::DescriptorBindingFlags, numBindings> bindingFlags;
+    std::array<vk::DescriptorPoolSize, numBindings> poolSizes;
+    for (uint32_t i = 0; i < numBindings; i++) {
+        bindings[i] = vk::DescriptorSetLayoutBinding{
+            i,                           // binding
+            descriptorTypes[i],          // descriptor type
+            capacities[i],               // descriptor count
+            vk::ShaderStageFlagBits::eAll,
+        };
+        // slots that aren't registered are never accessed, and registering happens while the set is bound
+        bindingFlags[i] = vk::DescriptorBindingFlagBits::eUpdateAfterBind | vk::DescriptorBindingFlagBits::ePartiallyBound;
+        poolSizes[i] = vk::DescriptorPoolSize{descriptorTypes[i], capacities[i]};
+        slots[i] = SlotAllocator(capacities[i]);
+    }
+
+    vk::StructureChain<vk::DescriptorSetLayoutCreateInfo, vk::DescriptorSetLayoutBindingFlagsCreateInfo> layoutInfo = {
+        {vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool, bindings},
+        {bindingFlags},
+    };
+    layout = device.createDescriptorSetLayout(layoutInfo.get<vk::DescriptorSetLayoutCreateInfo>());
+
+    vk::DescriptorPoolCreateInfo poolInfo = {
+        vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+        1,
+        poolSizes,
+    };
+    pool = device.createDescriptorPool(poolInfo);
+
+    vk::DescriptorSetAllocateInfo allocInfo = {
+        pool,
+        1,
+        &layout,
+    };
+    set = device.allocateDescriptorSets(allocInfo)[0];
+
+    vk::PushConstantRange pushConstants = {
+        vk::ShaderStageFlagBits::eAll,
+        0,
+        pushConstantSize,
+    };
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo = {
+        {},
+        layout,
+        pushConstants,
+    };
+    pipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+}
+void BindlessHeap::Destroy() {
+    if (!device) {
+        return;
+    }
+
+    device.destroyPipelineLayout(pipelineLayout);
+    device.destroyDescriptorPool(pool);
+    device.destroyDescriptorSetLayout(layout);
+    device = nullptr;
+}
+
+
+uint32_t BindlessHeap::RegisterStorageImage(VulkanImage const& image) {
+    uint32_t slot = slots[static_cast<uint32_t>(Binding::StorageImage)].Allocate();
+
+    vk::DescriptorImageInfo imageInfo = {{}, image, vk::ImageLayout::eGeneral};
+    Write(Binding::StorageImage, slot, &imageInfo, nullptr);
+    return slot;
+}
+uint32_t BindlessHeap::RegisterSampledImage(VulkanImage const& image) {
+    uint32_t slot = slots[static_cast<uint32_t>(Binding::SampledImage)].Allocate();
+
+    vk::DescriptorImageInfo imageInfo = {{}, image, vk::ImageLayout::eShaderReadOnlyOptimal};
+    Write(Binding::SampledImage, slot, &imageInfo, nullptr);
+    return slot;
+}
+uint32_t BindlessHeap::RegisterSampler(vk::Sampler sampler) {
+    uint32_t slot = slots[static_cast<uint32_t>(Binding::Sampler)].Allocate();
+
+    vk::DescriptorImageInfo imageInfo = {sampler};
+    Write(Binding::Sampler, slot, &imageInfo, nullptr);
+    return slot;
+}
+uint32_t BindlessHeap::RegisterStorageBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize range) {
+    uint32_t slot = slots[static_cast<uint32_t>(Binding::StorageBuffer)].Allocate();
+
+    vk::DescriptorBufferInfo bufferInfo = {buffer, offset, range};
+    Write(Binding::StorageBuffer, slot, nullptr, &bufferInfo);
+    return slot;
+}
+
+void BindlessHeap::Release(Binding binding, uint32_t handle, uint64_t retireValue) {
+    if (handle == invalidHandle) {
+        return;
+    }
+    slots[static_cast<uint32_t>(binding)].Release(handle, retireValue);
+}
+void BindlessHeap::CollectRetired(uint64_t completedValue) {
+    for (auto& allocator : slots) {
+        allocator.CollectRetired(completedValue);
+    }
+}
+
+void BindlessHeap::Bind(vk::CommandBuffer cmd, vk::PipelineBindPoint bindPoint) const {
+    cmd.bindDescriptorSets(bindPoint, pipelineLayout, 0, set, {});
+}
+
+void BindlessHeap::Write(Binding binding, uint32_t slot, vk::DescriptorImageInfo const* imageInfo, vk::DescriptorBufferInfo const* bufferInfo) {
+    auto bindingIndex = static_cast<uint32_t>(binding);
+
+    vk::WriteDescriptorSet write = {
+        set,                          // destination set
+        bindingIndex,                 // destination binding
+        slot,                         // destination array element
+        1,                            // descriptor count
+        descriptorTypes[bindingIndex], // descriptor type
+        imageInfo,
+        bufferInfo,
+    };
+
+    device.updateDescriptorSets(write, {});
+}
+
+}
\ No newline at end of file
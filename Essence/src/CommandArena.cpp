@@ -0,0 +1,74 @@
+#include "Lumina/Essence/CommandArena.hpp"
+
+#include <format>
+#include <stdexcept>
+
+namespace Lumina::Essence {
+
+void CommandArena::Initialize(vk::Device device, uint32_t queueFamily, uint32_t numThreads) {
+    this->device = device;
+
+    // buffers are never reset on their own, only the whole pool, which lets the driver skip per buffer bookkeeping
+    vk::CommandPoolCreateInfo poolInfo = {
+        {vk::CommandPoolCreateFlagBits::eTransient}, // flags
+        queueFamily,                                 // queue family index
+    };
+
+    threads.resize(numThreads);
+    for (auto& thread : threads) {
+        thread.pool = device.createCommandPool(poolInfo);
+    }
+}
+void CommandArena::Destroy() {
+    if (!device) {
+        return;
+    }
+
+    // frees the buffers as well
+    for (auto& thread : threads) {
+        device.destroyCommandPool(thread.pool);
+    }
+    threads.clear();
+    device = nullptr;
+}
+
+void CommandArena::Reset() {
+    for (auto& thread : threads) {
+        if (thread.numUsedPrimaries == 0 && thread.numUsedSecondaries == 0) {
+            continue;
+        }
+        device.resetCommandPool(thread.pool, {});
+        thread.numUsedPrimaries = 0;
+        thread.numUsedSecondaries = 0;
+    }
+}
+
+vk::CommandBuffer CommandArena::AllocatePrimary(uint32_t threadIndex) {
+    if (threadIndex >= threads.size()) {
+        throw std::out_of_range(std::format("Thread index {} is out of range, the arena has {} threads", threadIndex, threads.size()));
+    }
+    return Allocate(threads[threadIndex], vk::CommandBufferLevel::ePrimary);
+}
+vk::CommandBuffer CommandArena::AllocateSecondary(uint32_t threadIndex) {
+    if (threadIndex >= threads.size()) {
+        throw std::out_of_range(std::format("Thread index {} is out of range, the arena has {} threads", threadIndex, threads.size()));
+    }
+    return Allocate(threads[threadIndex], vk::CommandBufferLevel::eSecondary);
+}
+
+vk::CommandBuffer CommandArena::Allocate(ThreadCommands& thread, vk::CommandBufferLevel level) {
+    const bool isPrimary = level == vk::CommandBufferLevel::ePrimary;
+    auto& buffers = isPrimary ? thread.primaries : thread.secondaries;
+    auto& numUsed = isPrimary ? thread.numUsedPrimaries : thread.numUsedSecondaries;
+
+    if (numUsed == buffers.size()) {
+        buffers.push_back(device.allocateCommandBuffers({
+            thread.pool, // command pool
+            level,       // command buffer level
+            1,           // num buffers
+        })[0]);
+    }
+    return buffers[numUsed++];
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "Lumina/Essence/ComputeVariantCache.hpp"
+
+#include <algorithm>
+
+namespace Lumina::Essence {
+
+void ComputeVariantCache::Initialize(vk::Device device, PipelineCompiler& compiler, std::string const& shaderPath, vk::PipelineLayout layout) {
+    this->device = device;
+    this->compiler = &compiler;
+    this->shaderPath = shaderPath;
+    this->layout = layout;
+}
+void ComputeVariantCache::Destroy() {
+    for (auto& [constants, pipeline] : variants) {
+        pipeline.Destroy(device);
+    }
+    variants.clear();
+
+    for (auto& [constants, pipeline] : reloadedVariants) {
+        pipeline.Destroy(device);
+    }
+    reloadedVariants.clear();
+
+    for (auto& pipeline : supersededVariants) {
+        pipeline.Destroy(device);
+    }
+    supersededVariants.clear();
+}
+
+PipelineHandle ComputeVariantCache::Get(std::vector<SpecializationConstant> constants) {
+    std::ranges::sort(constants);
+
+    auto it = variants.find(constants);
+    if (it != variants.end()) {
+        return it->second;
+    }
+
+    PipelineHandle pipeline = compiler->CompileCompute(shaderPath, layout, constants);
+    variants.emplace(std::move(constants), pipeline);
+    return pipeline;
+}
+
+void ComputeVariantCache::Reload() {
+    // An earlier reload that is still compiling was never used, but destroying it now would wait for the
+    // compile on this thread. It goes once it's done instead.
+    for (auto& [constants, pipeline] : reloadedVariants) {
+        supersededVariants.push_back(pipeline);
+    }
+    reloadedVariants.clear();
+
+    for (auto const& [constants, pipeline] : variants) {
+        reloadedVariants.emplace(constants, compiler->CompileCompute(shaderPath, layout, constants));
+    }
+}
+
+bool ComputeVariantCache::SwapReloaded(RetirementQueue& retirementQueue, uint64_t retireValue) {
+    DestroyFinishedSuperseded();
+
+    if (reloadedVariants.empty()) {
+        return false;
+    }
+    for (auto const& [constants, pipeline] : reloadedVariants) {
+        if (!pipeline.IsReady()) {
+            return false;
+        }
+    }
+
+    for (auto& [constants, pipeline] : reloadedVariants) {
+        if (pipeline.HasFailed()) {
+            continue;
+        }
+
+        variants.at(constants).Retire(retirementQueue, retireValue, "reloaded compute pipeline");
+        variants.at(constants) = pipeline;
+    }
+    reloadedVariants.clear();
+    return true;
+}
+
+void ComputeVariantCache::DestroyFinishedSuperseded() {
+    std::erase_if(supersededVariants, [this](PipelineHandle& pipeline) {
+        if (!pipeline.IsReady()) {
+            return false;
+        }
+        pipeline.Destroy(device);
+        return true;
+    });
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "Lumina/Essence/CpuFractalRenderer.hpp"
+#include "Lumina/Essence/Utils/Platform.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define LUMINA_CPU_X86
+    #include <immintrin.h>
+    #if defined(LUMINA_COMPILER_MSVC)
+        #include <intrin.h>
+    #endif
+#endif
+
+// lets single functions use instructions beyond the baseline the rest of the library is compiled for
+#if defined(LUMINA_COMPILER_MSVC)
+    #define LUMINA_TARGET(features)
+#else
+    #define LUMINA_TARGET(features) __attribute__((target(features)))
+#endif
+
+namespace Lumina::Essence {
+
+namespace {
+
+// every kernel iterates this many points at once, narrower instruction sets take several steps
+constexpr uint32_t numLanes = 8;
+
+// Writes the iteration at which each point escaped, or -1 if it didn't within `maxIterations`.
+using IterateFunction = void (*)(float const* startX, float const* startY, glm::vec2 c, uint32_t maxIterations, float* escapeIterations);
+
+void IterateScalar(float const* startX, float const* startY, glm::vec2 c, uint32_t maxIterations, float* escapeIterations) {
+    for (uint32_t lane = 0; lane < numLanes; lane++) {
+        float x = startX[lane];
+        float y = startY[lane];
+        escapeIterations[lane] = -1;
+
+        for (uint32_t i = 0; i < maxIterations; i++) {
+            const float newX = x * x - y * y + c.x;
+            y = 2 * x * y + c.y;
+            x = newX;
+            if (x * x + y * y >= 4) {
+                escapeIterations[lane] = static_cast<float>(i);
+                break;
+            }
+        }
+    }
+}
+
+#if defined(LUMINA_CPU_X86)
+
+LUMINA_TARGET("sse2")
+void IterateSse2(float const* startX, float const* startY, glm::vec2 c, uint32_t maxIterations, float* escapeIterations) {
+    const __m128 cx = _mm_set1_ps(c.x);
+    const __m128 cy = _mm_set1_ps(c.y);
+    const __m128 four = _mm_set1_ps(4);
+
+    for (uint32_t half = 0; half < numLanes; half += 4) {
+        __m128 x = _mm_loadu_ps(startX + half);
+        __m128 y = _mm_loadu_ps(startY + half);
+        __m128 escapeIteration = _mm_set1_ps(-1);
+        __m128 active = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (uint32_t i = 0; i < maxIterations; i++) {
+            const __m128 xy = _mm_mul_ps(x, y);
+            x = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), cx);
+            y = _mm_add_ps(_mm_add_ps(xy, xy), cy);
+
+            const __m128 radius = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+            const __m128 escaped = _mm_and_ps(_mm_cmpge_ps(radius, four), active);
+            // no blend before SSE4.1
+            escapeIteration = _mm_or_ps(
+                _mm_and_ps(escaped, _mm_set1_ps(static_cast<float>(i))), _mm_andnot_ps(escaped, escapeIteration)
+            );
+            active = _mm_andnot_ps(escaped, active);
+            if (_mm_movemask_ps(active) == 0) {
+                break;
+            }
+        }
+        _mm_storeu_ps(escapeIterations + half, escapeIteration);
+    }
+}
+
+LUMINA_TARGET("avx2")
+void IterateAvx2(float const* startX, float const* startY, glm::vec2 c, uint32_t maxIterations, float* escapeIterations) {
+    const __m256 cx = _mm256_set1_ps(c.x);
+    const __m256 cy = _mm256_set1_ps(c.y);
+    const __m256 four = _mm256_set1_ps(4);
+
+    __m256 x = _mm256_loadu_ps(startX);
+    __m256 y = _mm256_loadu_ps(startY);
+    __m256 escapeIteration = _mm256_set1_ps(-1);
+    __m256 active = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+    // no fma, so the rounding matches the scalar path
+    for (uint32_t i = 0; i < maxIterations; i++) {
+        const __m256 xy = _mm256_mul_ps(x, y);
+        x = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), cx);
+        y = _mm256_add_ps(_mm256_add_ps(xy, xy), cy);
+
+        const __m256 radius = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+        const __m256 escaped = _mm256_and_ps(_mm256_cmp_ps(radius, four, _CMP_GE_OQ), active);
+        escapeIteration = _mm256_blendv_ps(escapeIteration, _mm256_set1_ps(static_cast<float>(i)), escaped);
+        active = _mm256_andnot_ps(escaped, active);
+        if (_mm256_testz_ps(active, active)) {
+            break;
+        }
+    }
+    _mm256_storeu_ps(escapeIterations, escapeIteration);
+}
+
+#endif
+
+IterateFunction GetIterateFunction(CpuFractalRenderer::InstructionSet instructionSet) {
+#if defined(LUMINA_CPU_X86)
+    switch (instructionSet) {
+    case CpuFractalRenderer::InstructionSet::Avx2:
+        return IterateAvx2;
+    case CpuFractalRenderer::InstructionSet::Sse2:
+        return IterateSse2;
+    default:
+        break;
+    }
+#endif
+    return IterateScalar;
+}
+
+// R2 low discrepancy sequence, same as sampleOffset() in gradient.comp
+glm::vec2 SampleOffset(uint32_t n) {
+    return glm::fract(glm::vec2(0.5f) + static_cast<float>(n) * glm::vec2(0.7548776662f, 0.5698402910f)) - 0.5f;
+}
+
+}
+
+CpuFractalRenderer::CpuFractalRenderer(InstructionSet instructionSet)
+    : instructionSet(instructionSet) {}
+
+CpuFractalRenderer::InstructionSet CpuFractalRenderer::DetectInstructionSet() {
+#if defined(LUMINA_CPU_X86)
+    #if defined(LUMINA_COMPILER_MSVC)
+    std::array<int, 4> registers = {};
+    __cpuid(registers.data(), 0);
+    if (registers[0] >= 7) {
+        __cpuidex(registers.data(), 7, 0);
+        if ((registers[1] & (1 << 5)) != 0) {
+            return InstructionSet::Avx2;
+        }
+    }
+    #else
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::Avx2;
+    }
+    #endif
+    // part of the x86-64 baseline
+    return InstructionSet::Sse2;
+#else
+    return InstructionSet::Scalar;
+#endif
+}
+
+
+void CpuFractalRenderer::Render(Parameters const& parameters, JobSystem& jobSystem) {
+    size = parameters.size;
+    pixels.resize(static_cast<size_t>(size.x) * size.y * 4);
+
+    const IterateFunction iterate = GetIterateFunction(instructionSet);
+    const uint32_t numTilesX = (size.x + tileSize - 1) / tileSize;
+    const uint32_t numTilesY = (size.y + tileSize - 1) / tileSize;
+
+    // the shader works in float too, start from the same values it does
+    const glm::vec2 center = parameters.center;
+    const auto pixelScale = static_cast<float>(parameters.pixelScale);
+    const glm::vec2 c = parameters.c;
+    const glm::vec2 halfSize = glm::vec2(size) / 2.0f;
+    const uint32_t numSamples = std::max(parameters.numSamples, 1u);
+
+    jobSystem.ParallelFor(numTilesX * numTilesY, [&](uint32_t tile) {
+        const glm::uvec2 tileBegin = glm::uvec2(tile % numTilesX, tile / numTilesX) * tileSize;
+        const glm::uvec2 tileEnd = glm::min(tileBegin + tileSize, size);
+
+        std::array<float, numLanes> startX;
+        std::array<float, numLanes> startY;
+        std::array<float, numLanes> escapeIterations;
+        std::array<float, numLanes> values;
+
+        for (uint32_t y = tileBegin.y; y < tileEnd.y; y++) {
+            for (uint32_t x = tileBegin.x; x < tileEnd.x; x += numLanes) {
+                // lanes past the end of the row iterate copies of the last pixel and are dropped
+                const uint32_t numPixels = std::min(numLanes, tileEnd.x - x);
+                values.fill(0);
+
+                for (uint32_t s = 0; s < numSamples; s++) {
+                    const glm::vec2 offset = SampleOffset(s) + 0.5f;
+                    for (uint32_t lane = 0; lane < numLanes; lane++) {
+                        const glm::vec2 texelCoord = glm::vec2(x + std::min(lane, numPixels - 1), y) + offset;
+                        const glm::vec2 z = center + (texelCoord - halfSize) * pixelScale;
+                        startX[lane] = z.x;
+                        startY[lane] = z.y;
+                    }
+
+                    iterate(startX.data(), startY.data(), c, parameters.maxIterations, escapeIterations.data());
+
+                    for (uint32_t lane = 0; lane < numLanes; lane++) {
+                        if (escapeIterations[lane] >= 0) {
+                            values[lane] += std::sqrt(escapeIterations[lane] / static_cast<float>(parameters.maxIterations));
+                        }
+                    }
+                }
+
+                // resolve and tint like julia_resolve.comp
+                for (uint32_t lane = 0; lane < numPixels; lane++) {
+                    const float value = values[lane] / static_cast<float>(numSamples);
+                    const glm::vec4 color = parameters.color1 * glm::vec4(glm::vec3(value), 1.0f);
+
+                    const uint64_t packed = glm::packHalf4x16(color);
+                    const size_t texel = (static_cast<size_t>(y) * size.x + x + lane) * 4;
+                    for (uint32_t channel = 0; channel < 4; channel++) {
+                        pixels[texel + channel] = static_cast<uint16_t>(packed >> (channel * 16));
+                    }
+                }
+            }
+        }
+    });
+}
+
+bool CpuFractalRenderer::Upload(vk::CommandBuffer cmd, StagingRing& stagingRing, VulkanImage& image) const {
+    if (image.GetFormat() != vk::Format::eR16G16B16A16Sfloat) {
+        throw std::runtime_error("CPU rendered pixels can only be uploaded to RGBA16F images!");
+    }
+
+    const vk::Extent3D imageExtent = image.GetExtent();
+    if (size.x > imageExtent.width || size.y > imageExtent.height) {
+        throw std::runtime_error(std::format(
+            "CPU rendered image ({}x{}) doesn't fit into the target ({}x{})!",
+            size.x,
+            size.y,
+            imageExtent.width,
+            imageExtent.height
+        ));
+    }
+
+    return stagingRing.Upload(cmd, image, {size.x, size.y, 1}, std::as_bytes(std::span(pixels)));
+}
+
+CpuFractalRenderer::Difference CpuFractalRenderer::Compare(std::span<const uint16_t> a, std::span<const uint16_t> b, float tolerance) {
+    if (a.size() != b.size()) {
+        throw std::runtime_error(std::format("Can't compare images of different sizes ({} and {} halfs)!", a.size(), b.size()));
+    }
+
+    Difference difference;
+    for (size_t texel = 0; texel < a.size(); texel += 4) {
+        float pixelError = 0;
+        for (size_t channel = texel; channel < std::min(texel + 4, a.size()); channel++) {
+            const float valueA = glm::unpackHalf1x16(a[channel]);
+            const float valueB = glm::unpackHalf1x16(b[channel]);
+            // also covers equal infinities, whose difference is NaN
+            if (valueA == valueB || (std::isnan(valueA) && std::isnan(valueB))) {
+                continue;
+            }
+            const float error = std::abs(valueA - valueB);
+            // NaN in only one of them counts as a mismatch
+            pixelError = std::isnan(error) ? std::numeric_limits<float>::infinity() : std::max(pixelError, error);
+        }
+
+        difference.maxError = std::max(difference.maxError, pixelError);
+        if (pixelError > tolerance) {
+            difference.numMismatches++;
+        }
+    }
+    return difference;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "Lumina/Essence/DeepZoom.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <future>
+
+namespace Lumina::Essence {
+
+void DeepZoom::Initialize(Application& app, BindlessHeap& heap, uint32_t numFrames) {
+    // written by the CPU whenever the view changes and read straight from there, one region per frame in flight
+    buffer = VulkanBuffer(
+        app,
+        regionSize * numFrames,
+        vk::BufferUsageFlagBits::eStorageBuffer,
+        VMA_MEMORY_USAGE_AUTO,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+    );
+
+    regions.clear();
+    for (uint32_t i = 0; i < numFrames; i++) {
+        regions.push_back({heap.RegisterStorageBuffer(buffer, regionSize * i, regionSize)});
+    }
+
+    orbitData.reserve(maxOrbitLength * 2);
+}
+void DeepZoom::Destroy() {
+    // the heap slots die with the heap
+    regions.clear();
+    buffer.Destroy();
+}
+
+
+void DeepZoom::SetJuliaParameter(glm::dvec2 c) {
+    if (c != this->c) {
+        this->c = c;
+        version++;
+    }
+}
+
+void DeepZoom::ZoomAt(glm::dvec2 offset, double factor) {
+    double newZoom = std::clamp(zoom * factor, 1e-2, maxZoom);
+    factor = newZoom / zoom;
+    if (factor == 1) {
+        return;
+    }
+
+    // the point under `offset` stays where it is
+    centerX += offset.x - offset.x / factor;
+    centerY += offset.y - offset.y / factor;
+    zoom = newZoom;
+    version++;
+}
+
+double DeepZoom::GetPixelScale(glm::vec2 renderSize) const {
+    // same mapping the shader used before, the larger axis spans 4 units at zoom 1
+    return 4.0 / std::max(renderSize.x, renderSize.y) / zoom;
+}
+
+uint32_t DeepZoom::GetMaxIterations() const {
+    double octaves = std::max(0.0, std::log2(zoom));
+    double iterations = settings.baseIterations + settings.iterationsPerOctave * octaves;
+    return static_cast<uint32_t>(std::min(iterations, static_cast<double>(maxOrbitLength - 1)));
+}
+
+
+DeepZoom::Parameters DeepZoom::Update(uint32_t frameIndex, glm::vec2 renderSize, JobSystem& jobSystem) {
+    if (settings != lastSettings) {
+        lastSettings = settings;
+        version++;
+    }
+
+    if (orbitVersion != version) {
+        ComputeOrbits(renderSize, jobSystem);
+        orbitVersion = version;
+    }
+
+    Region& region = regions.at(frameIndex);
+    if (region.version != orbitVersion) {
+        // host writes are visible to the GPU once the frame is submitted, no barrier needed
+        vk::DeviceSize offset = regionSize * frameIndex;
+        vk::DeviceSize size = orbitData.size() * sizeof(glm::vec2);
+        std::memcpy(static_cast<std::byte*>(buffer.GetMappedData()) + offset, orbitData.data(), size);
+        buffer.FlushMappedRange(offset, size);
+        region.version = orbitVersion;
+    }
+
+    return {
+        static_cast<float>(GetPixelScale(renderSize)),
+        referenceOffset,
+        region.heapIndex,
+        referenceLength,
+        referenceLength,
+        criticalLength,
+        GetMaxIterations(),
+    };
+}
+
+
+DeepZoom::Orbit DeepZoom::ComputeOrbit(DoubleDouble x, DoubleDouble y, glm::dvec2 c, uint32_t maxIterations) {
+    Orbit orbit;
+    orbit.points.reserve(maxIterations + 1);
+
+    for (uint32_t i = 0; i <= maxIterations; i++) {
+        orbit.points.emplace_back(static_cast<double>(x), static_cast<double>(y));
+
+        // the escaping point is kept, the shader still adds its offset to it before noticing the escape
+        double magnitude = static_cast<double>(x) * static_cast<double>(x) + static_cast<double>(y) * static_cast<double>(y);
+        if (magnitude >= 4) {
+            break;
+        }
+
+        DoubleDouble newX = x * x - y * y + c.x;
+        y = x * y * 2.0 + c.y;
+        x = newX;
+    }
+    return orbit;
+}
+
+void DeepZoom::ComputeOrbits(glm::vec2 renderSize, JobSystem& jobSystem) {
+    const uint32_t maxIterations = GetMaxIterations();
+    const double pixelScale = GetPixelScale(renderSize);
+
+    // candidates around the center, a reference that escapes early forces many pixels to rebase
+    const glm::dvec2 spread = glm::dvec2(renderSize) * pixelScale / 4.0;
+    const std::array<glm::dvec2, 9> candidateOffsets = {{
+        {0, 0},
+        {-spread.x, 0},
+        {spread.x, 0},
+        {0, -spread.y},
+        {0, spread.y},
+        {-spread.x, -spread.y},
+        {spread.x, -spread.y},
+        {-spread.x, spread.y},
+        {spread.x, spread.y},
+    }};
+    const size_t numCandidates = std::clamp<size_t>(settings.numCandidates, 1, candidateOffsets.size());
+
+    std::vector<std::future<Orbit>> candidates;
+    for (size_t i = 0; i < numCandidates; i++) {
+        glm::dvec2 offset = candidateOffsets[i];
+        candidates.push_back(jobSystem.SubmitLong([=, this]() {
+            Orbit orbit = ComputeOrbit(centerX + offset.x, centerY + offset.y, c, maxIterations);
+            orbit.start = offset;
+            return orbit;
+        }));
+    }
+    // the critical point doesn't depend on the view, but it is just as cheap to compute alongside
+    auto criticalOrbit = jobSystem.SubmitLong([=, this]() { return ComputeOrbit(0, 0, c, std::max(maxIterations, 1u)); });
+
+    Orbit best;
+    for (auto& candidate : candidates) {
+        Orbit orbit = candidate.get();
+        if (orbit.points.size() > best.points.size()) {
+            best = std::move(orbit);
+        }
+    }
+    Orbit critical = criticalOrbit.get();
+
+    // rebasing onto the critical orbit needs at least one step to take
+    if (critical.points.size() < 2) {
+        critical.points.emplace_back(c);
+    }
+
+    orbitData.clear();
+    orbitData.insert(orbitData.end(), best.points.begin(), best.points.end());
+    orbitData.insert(orbitData.end(), critical.points.begin(), critical.points.end());
+
+    referenceOffset = glm::vec2(best.start);
+    referenceLength = static_cast<uint32_t>(best.points.size());
+    criticalLength = static_cast<uint32_t>(critical.points.size());
+}
+
+
+void DeepZoom::DrawImGui() {
+    ImGui::Begin("Deep Zoom");
+
+    double log10Zoom = std::log10(zoom);
+    double minLog10Zoom = -2;
+    double maxLog10Zoom = std::log10(maxZoom);
+    if (ImGui::SliderScalar("Zoom (log10)", ImGuiDataType_Double, &log10Zoom, &minLog10Zoom, &maxLog10Zoom)) {
+        ZoomAt({0, 0}, std::pow(10.0, log10Zoom) / zoom);
+    }
+
+    ImGui::Text("Center: %.17g", static_cast<double>(centerX));
+    ImGui::Text("        %.17g", static_cast<double>(centerY));
+    ImGui::Text("Iterations: %u", GetMaxIterations());
+    ImGui::Text("Reference: %u steps, critical orbit: %u steps", referenceLength, criticalLength);
+
+    int baseIterations = static_cast<int>(settings.baseIterations);
+    int iterationsPerOctave = static_cast<int>(settings.iterationsPerOctave);
+    int numCandidates = static_cast<int>(settings.numCandidates);
+    if (ImGui::SliderInt("Base iterations", &baseIterations, 10, 2000)) {
+        settings.baseIterations = static_cast<uint32_t>(baseIterations);
+    }
+    if (ImGui::SliderInt("Iterations per octave", &iterationsPerOctave, 0, 200)) {
+        settings.iterationsPerOctave = static_cast<uint32_t>(iterationsPerOctave);
+    }
+    if (ImGui::SliderInt("Reference candidates", &numCandidates, 1, 9)) {
+        settings.numCandidates = static_cast<uint32_t>(numCandidates);
+    }
+
+    if (ImGui::Button("Reset view")) {
+        centerX = 0;
+        centerY = 0;
+        zoom = 1;
+        version++;
+    }
+
+    ImGui::End();
+}
+
+}
\ No newline at end of file
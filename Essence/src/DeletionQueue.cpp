@@ -1,6 +1,6 @@
 #include "Lumina/Essence/DeletionQueue.hpp"
+#include "Lumina/Essence/Log.hpp"
 
-#include <iostream>
 #include <ranges>
 
 namespace Lumina::Essence {
@@ -14,7 +14,7 @@ void DeletionQueue::PushBack(std::function<void()> const&& deletor, std::string
 void DeletionQueue::Flush() {
     for (auto& it : std::ranges::reverse_view(queue)) {
         std::get<0>(it)();
-        std::cout << "Deleted " << std::get<1>(it) << "\n";
+        LUMINA_LOG_DEBUG(Resources, "Deleted {}", std::get<1>(it));
     }
 
     queue.clear();
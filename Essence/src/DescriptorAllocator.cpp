@@ -0,0 +1,96 @@
+#include "Lumina/Essence/DescriptorAllocator.hpp"
+
+#include <algorithm>
+
+namespace Lumina::Essence {
+
+void DescriptorAllocator::Initialize(vk::Device device, uint32_t initialSets, std::span<const PoolSizeRatio> poolRatios) {
+    this->device = device;
+    ratios.assign(poolRatios.begin(), poolRatios.end());
+
+    readyPools.push_back(CreatePool(initialSets));
+    setsPerPool = std::min(static_cast<uint32_t>(static_cast<float>(initialSets) * growthFactor), maxSetsPerPool);
+}
+void DescriptorAllocator::Destroy() {
+    if (!device) {
+        return;
+    }
+
+    for (auto pool : readyPools) {
+        device.destroyDescriptorPool(pool);
+    }
+    for (auto pool : fullPools) {
+        device.destroyDescriptorPool(pool);
+    }
+    readyPools.clear();
+    fullPools.clear();
+    device = nullptr;
+}
+
+void DescriptorAllocator::Reset() {
+    for (auto pool : readyPools) {
+        device.resetDescriptorPool(pool, {});
+    }
+    for (auto pool : fullPools) {
+        device.resetDescriptorPool(pool, {});
+        readyPools.push_back(pool);
+    }
+    fullPools.clear();
+}
+
+vk::DescriptorSet DescriptorAllocator::Allocate(vk::DescriptorSetLayout layout, void const* pNext) {
+    vk::DescriptorPool pool = GetPool();
+
+    vk::DescriptorSetAllocateInfo info = {
+        pool,
+        1,
+        &layout,
+        pNext,
+    };
+
+    // the raw overload reports running out of memory as a result instead of an exception
+    vk::DescriptorSet set;
+    vk::Result result = device.allocateDescriptorSets(&info, &set);
+    if (result == vk::Result::eErrorOutOfPoolMemory || result == vk::Result::eErrorFragmentedPool) {
+        fullPools.push_back(pool);
+
+        pool = GetPool();
+        info.descriptorPool = pool;
+        VkCheck(device.allocateDescriptorSets(&info, &set));
+    }
+    else {
+        VkCheck(result);
+    }
+
+    readyPools.push_back(pool);
+    return set;
+}
+
+vk::DescriptorPool DescriptorAllocator::GetPool() {
+    if (!readyPools.empty()) {
+        vk::DescriptorPool pool = readyPools.back();
+        readyPools.pop_back();
+        return pool;
+    }
+
+    vk::DescriptorPool pool = CreatePool(setsPerPool);
+    setsPerPool = std::min(static_cast<uint32_t>(static_cast<float>(setsPerPool) * growthFactor), maxSetsPerPool);
+    return pool;
+}
+
+vk::DescriptorPool DescriptorAllocator::CreatePool(uint32_t numSets) {
+    std::vector<vk::DescriptorPoolSize> poolSizes;
+    for (auto ratio : ratios) {
+        poolSizes.emplace_back(ratio.type, std::max(1u, static_cast<uint32_t>(ratio.ratio * static_cast<float>(numSets))));
+    }
+
+    vk::DescriptorPoolCreateInfo poolInfo = {
+        {},
+        numSets,
+        poolSizes,
+    };
+
+    return device.createDescriptorPool(poolInfo);
+}
+
+}
\ No newline at end of file
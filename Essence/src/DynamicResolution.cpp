@@ -0,0 +1,60 @@
+#include "Lumina/Essence/DynamicResolution.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Lumina::Essence {
+
+void DynamicResolution::Update(float gpuFrameTimeMs) {
+    if (!settings.enabled || gpuFrameTimeMs <= 0) {
+        return;
+    }
+
+    accumulatedFrameTimeMs += gpuFrameTimeMs;
+    numSamples++;
+
+    // measurements lag behind by the frames in flight, so average over a few frames before reacting again
+    if (numSamples < std::max(settings.settleFrames, 1u)) {
+        return;
+    }
+
+    float averageMs = accumulatedFrameTimeMs / static_cast<float>(numSamples);
+    accumulatedFrameTimeMs = 0;
+    numSamples = 0;
+
+    float error = averageMs / settings.targetFrameTimeMs;
+    if (std::abs(error - 1.0f) <= settings.hysteresis) {
+        return;
+    }
+
+    // frame time is roughly proportional to the pixel count, which grows with the square of the scale
+    float step = std::sqrt(1.0f / error);
+    step = std::min(step, settings.maxStepUp);
+
+    scale = std::clamp(scale * step, settings.minScale, settings.maxScale);
+}
+
+vk::Extent2D DynamicResolution::GetRenderExtent(vk::Extent2D maxExtent) const {
+    float currentScale = GetScale();
+    return {
+        std::clamp(static_cast<uint32_t>(static_cast<float>(maxExtent.width) * currentScale), 1u, maxExtent.width),
+        std::clamp(static_cast<uint32_t>(static_cast<float>(maxExtent.height) * currentScale), 1u, maxExtent.height),
+    };
+}
+
+void DynamicResolution::DrawImGui() {
+    ImGui::Begin("Dynamic Resolution");
+
+    ImGui::Checkbox("Enabled", &settings.enabled);
+    ImGui::SliderFloat("Target [ms]", &settings.targetFrameTimeMs, 1.0f, 100.0f);
+    ImGui::SliderFloat("Min scale", &settings.minScale, 0.1f, 1.0f);
+    ImGui::SliderFloat("Max scale", &settings.maxScale, settings.minScale, 1.0f);
+    ImGui::SliderFloat("Hysteresis", &settings.hysteresis, 0.0f, 0.5f);
+    ImGui::Text("Scale: %.3f", GetScale());
+
+    ImGui::End();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include "Lumina/Essence/GpuProfiler.hpp"
+#include "Lumina/Essence/Log.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <format>
+#include <stdexcept>
+
+namespace Lumina::Essence {
+
+GpuProfiler::Zone::Zone(GpuProfiler* profiler, vk::CommandBuffer cmd, uint32_t queryPair)
+    : profiler(profiler), cmd(cmd), queryPair(queryPair) {}
+
+GpuProfiler::Zone::~Zone() {
+    if (profiler != nullptr) {
+        profiler->EndZone(cmd, queryPair);
+    }
+}
+
+
+void GpuProfiler::Initialize(vk::PhysicalDevice physicalDevice, vk::Device device, uint32_t queueFamily) {
+    this->device = device;
+
+    auto properties = physicalDevice.getProperties();
+    auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+    uint32_t validBits = queueFamilies.at(queueFamily).timestampValidBits;
+
+    enabled = validBits != 0 && properties.limits.timestampPeriod > 0;
+    timestampPeriod = properties.limits.timestampPeriod;
+    timestampMask = validBits >= 64 ? std::numeric_limits<uint64_t>::max() : ((uint64_t(1) << validBits) - 1);
+
+    queryResults.resize(maxZonesPerFrame * 2);
+
+    if (!enabled) {
+        LUMINA_LOG_WARNING(Profiling, "GPU timestamps aren't supported on this queue, profiling is disabled");
+    }
+}
+void GpuProfiler::CreateFrameQueries(FrameQueries& frame) {
+    frame.zoneIds.reserve(maxZonesPerFrame);
+    if (!enabled) {
+        return;
+    }
+
+    vk::QueryPoolCreateInfo poolInfo = {
+        {},                         // flags
+        vk::QueryType::eTimestamp,  // query type
+        maxZonesPerFrame * 2,       // num queries
+    };
+    frame.queryPool = device.createQueryPool(poolInfo);
+}
+void GpuProfiler::DestroyFrameQueries(FrameQueries& frame) {
+    if (frame.queryPool) {
+        device.destroyQueryPool(frame.queryPool);
+        frame.queryPool = nullptr;
+    }
+    frame.zoneIds.clear();
+}
+
+
+void GpuProfiler::BeginFrame(vk::CommandBuffer cmd, FrameQueries& frame) {
+    currentFrame = &frame;
+    if (!enabled) {
+        return;
+    }
+
+    CollectResults(frame);
+
+    frame.zoneIds.clear();
+    cmd.resetQueryPool(frame.queryPool, 0, maxZonesPerFrame * 2);
+}
+
+GpuProfiler::Zone GpuProfiler::Scope(vk::CommandBuffer cmd, std::string const& name) {
+    if (!enabled || currentFrame == nullptr || currentFrame->zoneIds.size() >= maxZonesPerFrame) {
+        return {nullptr, cmd, 0};
+    }
+
+    auto queryPair = static_cast<uint32_t>(currentFrame->zoneIds.size());
+    currentFrame->zoneIds.push_back(GetZoneId(name));
+
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, currentFrame->queryPool, queryPair * 2);
+    return {this, cmd, queryPair};
+}
+
+void GpuProfiler::EndZone(vk::CommandBuffer cmd, uint32_t queryPair) {
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, currentFrame->queryPool, queryPair * 2 + 1);
+}
+
+
+void GpuProfiler::CollectResults(FrameQueries& frame) {
+    if (frame.zoneIds.empty()) {
+        return;
+    }
+
+    auto numQueries = static_cast<uint32_t>(frame.zoneIds.size() * 2);
+    // the frame that wrote these queries has retired, so this never waits
+    vk::Result res = device.getQueryPoolResults(
+        frame.queryPool,
+        0,
+        numQueries,
+        numQueries * sizeof(uint64_t),
+        queryResults.data(),
+        sizeof(uint64_t),
+        vk::QueryResultFlagBits::e64
+    );
+    if (res != vk::Result::eSuccess) {
+        return;
+    }
+
+    const float ticksToMs = timestampPeriod / 1e6f;
+
+    uint64_t frameBegin = std::numeric_limits<uint64_t>::max();
+    uint64_t frameEnd = 0;
+    for (size_t i = 0; i < frame.zoneIds.size(); i++) {
+        uint64_t begin = queryResults[i * 2] & timestampMask;
+        uint64_t end = queryResults[i * 2 + 1] & timestampMask;
+
+        auto& zone = zones.at(frame.zoneIds[i]);
+        zone.frameAccumulator += static_cast<float>((end - begin) & timestampMask) * ticksToMs;
+        zone.seenThisFrame = true;
+
+        frameBegin = std::min(frameBegin, begin);
+        frameEnd = std::max(frameEnd, end);
+    }
+
+    for (auto& zone : zones) {
+        if (zone.seenThisFrame) {
+            PushSample(zone, zone.frameAccumulator);
+        }
+        zone.frameAccumulator = 0;
+        zone.seenThisFrame = false;
+    }
+
+    lastFrameMs = static_cast<float>((frameEnd - frameBegin) & timestampMask) * ticksToMs;
+    PushSample(frameHistory, lastFrameMs);
+}
+
+uint32_t GpuProfiler::GetZoneId(std::string const& name) {
+    auto it = zoneIds.find(name);
+    if (it != zoneIds.end()) {
+        return it->second;
+    }
+
+    auto id = static_cast<uint32_t>(zones.size());
+    zones.push_back({name});
+    zoneIds.emplace(name, id);
+    return id;
+}
+
+void GpuProfiler::PushSample(ZoneHistory& zone, float sample) {
+    if (zone.samples.empty()) {
+        zone.samples.resize(historySize);
+    }
+
+    zone.samples[zone.nextSample] = sample;
+    zone.nextSample = (zone.nextSample + 1) % historySize;
+    zone.numSamples = std::min(zone.numSamples + 1, historySize);
+}
+
+GpuProfiler::Statistics GpuProfiler::ComputeStatistics(ZoneHistory const& zone) {
+    Statistics stats = {zone.name};
+    if (zone.numSamples == 0) {
+        return stats;
+    }
+
+    std::vector<float> sorted(zone.samples.begin(), zone.samples.begin() + zone.numSamples);
+    std::ranges::sort(sorted);
+
+    float sum = 0;
+    for (float sample : sorted) {
+        sum += sample;
+    }
+
+    stats.lastMs = zone.samples[(zone.nextSample + historySize - 1) % historySize];
+    stats.minMs = sorted.front();
+    stats.avgMs = sum / static_cast<float>(sorted.size());
+    stats.p99Ms = sorted[std::min(sorted.size() - 1, static_cast<size_t>(static_cast<float>(sorted.size()) * 0.99f))];
+    stats.numSamples = zone.numSamples;
+    return stats;
+}
+
+std::vector<GpuProfiler::Statistics> GpuProfiler::GetStatistics() const {
+    std::vector<Statistics> stats;
+    stats.reserve(zones.size() + 1);
+
+    stats.push_back(ComputeStatistics(frameHistory));
+    for (auto const& zone : zones) {
+        stats.push_back(ComputeStatistics(zone));
+    }
+    return stats;
+}
+
+
+void GpuProfiler::DrawImGui() {
+    ImGui::Begin("GPU Profiler");
+
+    if (!enabled) {
+        ImGui::Text("GPU timestamps aren't supported");
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::BeginTable("zones", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Last [ms]");
+        ImGui::TableSetupColumn("Min [ms]");
+        ImGui::TableSetupColumn("Avg [ms]");
+        ImGui::TableSetupColumn("P99 [ms]");
+        ImGui::TableHeadersRow();
+
+        for (auto const& stats : GetStatistics()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(stats.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.lastMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.minMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.avgMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.p99Ms);
+        }
+        ImGui::EndTable();
+    }
+
+    // e.g. a read only working directory, not worth ending the application for
+    try {
+        if (ImGui::Button("Dump CSV")) {
+            WriteCsv("gpu_profile.csv");
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Dump JSON")) {
+            WriteJson("gpu_profile.json");
+        }
+    }
+    catch (std::exception const& e) {
+        LUMINA_LOG_ERROR(Profiling, "Failed to dump the GPU profile: {}", e.what());
+    }
+
+    ImGui::End();
+}
+
+void GpuProfiler::WriteCsv(std::filesystem::path const& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Failed to open file \"{}\"!", path.string()));
+    }
+
+    file << "zone,last_ms,min_ms,avg_ms,p99_ms,samples\n";
+    for (auto const& stats : GetStatistics()) {
+        file << std::format(
+            "{},{},{},{},{},{}\n", stats.name, stats.lastMs, stats.minMs, stats.avgMs, stats.p99Ms, stats.numSamples
+        );
+    }
+}
+void GpuProfiler::WriteJson(std::filesystem::path const& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Failed to open file \"{}\"!", path.string()));
+    }
+
+    auto stats = GetStatistics();
+    file << "{\n  \"zones\": [\n";
+    for (size_t i = 0; i < stats.size(); i++) {
+        file << std::format(
+            "    {{\"name\": \"{}\", \"last_ms\": {}, \"min_ms\": {}, \"avg_ms\": {}, \"p99_ms\": {}, \"samples\": {}}}{}\n",
+            stats[i].name,
+            stats[i].lastMs,
+            stats[i].minMs,
+            stats[i].avgMs,
+            stats[i].p99Ms,
+            stats[i].numSamples,
+            i + 1 < stats.size() ? "," : ""
+        );
+    }
+    file << "  ]\n}\n";
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "Lumina/Essence/Log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Lumina::Essence {
+
+namespace {
+
+constexpr size_t slotTextSize = 224;
+constexpr uint32_t slotsPerRing = 512; // about 128KiB per logging thread
+// how long the writer sleeps when there is nothing to write
+constexpr auto writerIdleTime = std::chrono::milliseconds(5);
+
+struct Slot {
+    std::chrono::steady_clock::time_point time;
+    LogLevel level;
+    LogCategory category;
+    bool isContinued; // the message goes on in the next slot
+    bool isTruncated;
+    uint16_t length;
+    std::array<char, slotTextSize> text;
+};
+
+// Single producer (the owning thread), single consumer (whoever holds the write mutex).
+struct Ring {
+    std::array<Slot, slotsPerRing> slots;
+    alignas(64) std::atomic<uint32_t> head = 0; // next slot the producer fills
+    alignas(64) std::atomic<uint32_t> tail = 0; // next slot the consumer reads
+    uint32_t threadIndex = 0;
+};
+
+std::string_view GetLevelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace:
+        return "trace";
+    case LogLevel::Debug:
+        return "debug";
+    case LogLevel::Info:
+        return "info";
+    case LogLevel::Warning:
+        return "warning";
+    case LogLevel::Error:
+        return "error";
+    }
+    return "?";
+}
+
+std::string_view GetCategoryName(LogCategory category) {
+    switch (category) {
+    case LogCategory::General:
+        return "general";
+    case LogCategory::Vulkan:
+        return "vulkan";
+    case LogCategory::Pipelines:
+        return "pipelines";
+    case LogCategory::Resources:
+        return "resources";
+    case LogCategory::Profiling:
+        return "profiling";
+    case LogCategory::Count:
+        break;
+    }
+    return "?";
+}
+
+class Backend {
+public:
+    static Backend& Get() {
+        static Backend backend;
+        return backend;
+    }
+
+    Backend()
+        : startTime(std::chrono::steady_clock::now()) {
+        for (auto& level : levels) {
+            level = LogLevel::Trace;
+        }
+        writer = std::thread([this]() { WriterLoop(); });
+    }
+
+    ~Backend() {
+        {
+            std::scoped_lock lock(wakeMutex);
+            isStopping = true;
+        }
+        wakeWriter.notify_one();
+        writer.join();
+
+        Drain();
+        if (output != stdout) {
+            std::fclose(output);
+        }
+    }
+
+    Ring& GetThreadRing() {
+        thread_local Ring* ring = nullptr;
+        if (ring == nullptr) {
+            // once per thread, the rings live as long as the logger
+            std::scoped_lock lock(ringsMutex);
+            rings.push_back(std::make_unique<Ring>());
+            ring = rings.back().get();
+            ring->threadIndex = static_cast<uint32_t>(rings.size() - 1);
+        }
+        return *ring;
+    }
+
+    void Push(LogLevel level, LogCategory category, std::string_view message, bool isTruncated) {
+        Ring& ring = GetThreadRing();
+        const auto numSlots = static_cast<uint32_t>(std::max<size_t>(1, (message.size() + slotTextSize - 1) / slotTextSize));
+
+        const uint32_t head = ring.head.load(std::memory_order_relaxed);
+        const uint32_t tail = ring.tail.load(std::memory_order_acquire);
+        if (head - tail + numSlots > slotsPerRing) {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const auto time = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < numSlots; i++) {
+            Slot& slot = ring.slots[(head + i) % slotsPerRing];
+            std::string_view part = message.substr(std::min(message.size(), i * slotTextSize), slotTextSize);
+
+            slot.time = time;
+            slot.level = level;
+            slot.category = category;
+            slot.isContinued = i + 1 < numSlots;
+            slot.isTruncated = isTruncated;
+            slot.length = static_cast<uint16_t>(part.size());
+            std::ranges::copy(part, slot.text.begin());
+        }
+        ring.head.store(head + numSlots, std::memory_order_release);
+
+        // errors are written right away, the process might not survive long enough for the next pass
+        if (level >= LogLevel::Error) {
+            wakeWriter.notify_one();
+        }
+    }
+
+    void Drain() {
+        std::scoped_lock lock(writeMutex);
+
+        std::vector<Ring*> snapshot;
+        {
+            std::scoped_lock ringsLock(ringsMutex);
+            for (auto const& ring : rings) {
+                snapshot.push_back(ring.get());
+            }
+        }
+
+        text.clear();
+        for (Ring* ring : snapshot) {
+            const uint32_t head = ring->head.load(std::memory_order_acquire);
+            uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+
+            while (tail != head) {
+                Slot const& first = ring->slots[tail % slotsPerRing];
+                const double seconds = std::chrono::duration<double>(first.time - startTime).count();
+                std::format_to(
+                    std::back_inserter(text),
+                    "[{:10.4f}][{}][{}][{}] ",
+                    seconds,
+                    ring->threadIndex,
+                    GetLevelName(first.level),
+                    GetCategoryName(first.category)
+                );
+
+                bool isTruncated = false;
+                while (true) {
+                    Slot const& slot = ring->slots[tail % slotsPerRing];
+                    text.append(slot.text.data(), slot.length);
+                    isTruncated = slot.isTruncated;
+                    tail++;
+                    if (!slot.isContinued) {
+                        break;
+                    }
+                }
+                text += isTruncated ? "...\n" : "\n";
+            }
+            ring->tail.store(tail, std::memory_order_release);
+        }
+
+        if (uint32_t dropped = numDropped.exchange(0, std::memory_order_relaxed); dropped != 0) {
+            std::format_to(std::back_inserter(text), "[log] dropped {} messages, the ring buffers were full\n", dropped);
+        }
+
+        if (!text.empty()) {
+            std::fwrite(text.data(), 1, text.size(), output);
+            std::fflush(output);
+        }
+    }
+
+    void SetOutputFile(std::filesystem::path const& path) {
+        Drain();
+
+        std::scoped_lock lock(writeMutex);
+        std::FILE* file = std::fopen(path.string().c_str(), "w");
+        if (file == nullptr) {
+            throw std::runtime_error(std::format("Failed to open log file \"{}\"!", path.string()));
+        }
+        if (output != stdout) {
+            std::fclose(output);
+        }
+        output = file;
+    }
+
+    std::array<std::atomic<LogLevel>, static_cast<size_t>(LogCategory::Count)> levels;
+
+private:
+    void WriterLoop() {
+        std::unique_lock lock(wakeMutex);
+        while (!isStopping) {
+            lock.unlock();
+            Drain();
+            lock.lock();
+
+            wakeWriter.wait_for(lock, writerIdleTime);
+        }
+    }
+
+    const std::chrono::steady_clock::time_point startTime;
+
+    std::mutex ringsMutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::atomic<uint32_t> numDropped = 0;
+
+    std::mutex writeMutex;
+    std::string text; // reused by every pass
+    std::FILE* output = stdout;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeWriter;
+    bool isStopping = false;
+    std::thread writer;
+};
+
+}
+
+void Log::SetOutputFile(std::filesystem::path const& path) {
+    Backend::Get().SetOutputFile(path);
+}
+
+void Log::SetLevel(LogCategory category, LogLevel level) {
+    Backend::Get().levels.at(static_cast<size_t>(category)).store(level, std::memory_order_relaxed);
+}
+
+void Log::Flush() {
+    Backend::Get().Drain();
+}
+
+bool Log::IsEnabled(LogLevel level, LogCategory category) {
+    return level >= Backend::Get().levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+std::span<char> Log::GetScratchBuffer() {
+    thread_local std::array<char, maxMessageLength> scratch;
+    return scratch;
+}
+
+void Log::Push(LogLevel level, LogCategory category, std::string_view message, bool isTruncated) {
+    Backend::Get().Push(level, category, message, isTruncated);
+}
+
+}
\ No newline at end of file
@@ -70,7 +70,10 @@ void PipelineBuilder::SetPipelineLayout(vk::PipelineLayout layout) {
 }
 
 
-vk::Pipeline PipelineBuilder::Build(vk::Device device) {
+vk::Pipeline PipelineBuilder::Build(vk::Device device, vk::PipelineCache pipelineCache) {
+    // the builder might have been copied since SetColorAttachmentFormat, don't point into the original
+    renderInfo.setColorAttachmentFormats(colorAttachmentFormat);
+
     vk::PipelineViewportStateCreateInfo viewportState = {
         {},
         1,
@@ -111,6 +114,6 @@ vk::Pipeline PipelineBuilder::Build(vk::Device device) {
         pipelineLayout,
     };
 
-    return VkCheck(device.createGraphicsPipeline(nullptr, pipelineInfo));
+    return VkCheck(device.createGraphicsPipeline(pipelineCache, pipelineInfo));
 }
 }
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "Lumina/Essence/PipelineCache.hpp"
+#include "Lumina/Essence/Utils/FileIO.hpp"
+#include "Lumina/Essence/Utils/Hash.hpp"
+#include "Lumina/Essence/Utils/Packed.hpp"
+#include "Lumina/Essence/Log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace Lumina::Essence {
+
+namespace {
+
+constexpr uint32_t cacheFileMagic = 0x4843504c; // "LPCH"
+constexpr uint32_t cacheFileVersion = 1;
+
+// file layout: CacheFileHeader, DeviceIdentity, vulkan pipeline cache blob
+LUMINA_PACKED(struct CacheFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t dataSize;
+    uint64_t dataHash;
+});
+
+}
+
+void PipelineCache::Initialize(vk::PhysicalDevice physicalDevice, vk::Device device, std::string const& path) {
+    this->device = device;
+    this->path = path;
+
+    auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>();
+    auto const& deviceProperties = properties.get<vk::PhysicalDeviceProperties2>().properties;
+    auto const& idProperties = properties.get<vk::PhysicalDeviceIDProperties>();
+
+    identity.vendorID = deviceProperties.vendorID;
+    identity.deviceID = deviceProperties.deviceID;
+    identity.driverVersion = deviceProperties.driverVersion;
+    std::ranges::copy(idProperties.driverUUID, identity.driverUUID.begin());
+    std::ranges::copy(deviceProperties.pipelineCacheUUID, identity.pipelineCacheUUID.begin());
+
+    std::vector<uint8_t> blob = LoadValidatedBlob();
+    isWarm = !blob.empty();
+
+    vk::PipelineCacheCreateInfo cacheInfo = {
+        {},          // flags
+        blob.size(), // initial data size
+        blob.data(), // initial data
+    };
+    cache = device.createPipelineCache(cacheInfo);
+
+    LUMINA_LOG_INFO(Pipelines, "{} {}", isWarm ? "Loaded pipeline cache from" : "Starting with an empty pipeline cache at", path);
+}
+
+std::vector<uint8_t> PipelineCache::LoadValidatedBlob() const {
+    if (!std::filesystem::exists(path)) {
+        return {};
+    }
+
+    std::vector<uint8_t> bytes = ReadBinaryFile(path);
+
+    CacheFileHeader fileHeader = {};
+    DeviceIdentity fileIdentity = {};
+    if (bytes.size() < sizeof(fileHeader) + sizeof(fileIdentity)) {
+        LUMINA_LOG_WARNING(Pipelines, "Pipeline cache is truncated, ignoring it");
+        return {};
+    }
+    std::memcpy(&fileHeader, bytes.data(), sizeof(fileHeader));
+    std::memcpy(&fileIdentity, bytes.data() + sizeof(fileHeader), sizeof(fileIdentity));
+
+    std::span<const uint8_t> blob = std::span(bytes).subspan(sizeof(fileHeader) + sizeof(fileIdentity));
+
+    if (fileHeader.magic != cacheFileMagic || fileHeader.version != cacheFileVersion) {
+        LUMINA_LOG_WARNING(Pipelines, "Pipeline cache has an unknown format, ignoring it");
+        return {};
+    }
+    if (fileHeader.dataSize != blob.size() || fileHeader.dataHash != Fnv1a64(blob)) {
+        LUMINA_LOG_WARNING(Pipelines, "Pipeline cache is corrupted, ignoring it");
+        return {};
+    }
+    if (std::memcmp(&fileIdentity, &identity, sizeof(identity)) != 0) {
+        LUMINA_LOG_WARNING(Pipelines, "Pipeline cache was written by a different device or driver, ignoring it");
+        return {};
+    }
+
+    // the driver validates its own header too, but an invalid one would silently give us an empty cache
+    vk::PipelineCacheHeaderVersionOne vulkanHeader = {};
+    if (blob.size() < sizeof(vulkanHeader)) {
+        return {};
+    }
+    std::memcpy(&vulkanHeader, blob.data(), sizeof(vulkanHeader));
+    if (vulkanHeader.headerVersion != vk::PipelineCacheHeaderVersion::eOne
+        || vulkanHeader.vendorID != identity.vendorID
+        || vulkanHeader.deviceID != identity.deviceID
+        || !std::ranges::equal(vulkanHeader.pipelineCacheUUID, identity.pipelineCacheUUID)) {
+        LUMINA_LOG_WARNING(Pipelines, "Pipeline cache has a mismatching vulkan header, ignoring it");
+        return {};
+    }
+
+    return {blob.begin(), blob.end()};
+}
+
+void PipelineCache::Save() {
+    std::vector<uint8_t> blob = device.getPipelineCacheData(cache);
+
+    CacheFileHeader fileHeader = {
+        cacheFileMagic,
+        cacheFileVersion,
+        blob.size(),
+        Fnv1a64(blob),
+    };
+
+    std::vector<uint8_t> bytes(sizeof(fileHeader) + sizeof(identity) + blob.size());
+    std::memcpy(bytes.data(), &fileHeader, sizeof(fileHeader));
+    std::memcpy(bytes.data() + sizeof(fileHeader), &identity, sizeof(identity));
+    std::ranges::copy(blob, bytes.begin() + sizeof(fileHeader) + sizeof(identity));
+
+    // runs during shutdown, a missing cache only makes the next start slower
+    try {
+        WriteBinaryFileAtomically(path, bytes);
+    }
+    catch (std::exception const& e) {
+        LUMINA_LOG_WARNING(Pipelines, "Failed to save pipeline cache to {}: {}", path, e.what());
+        return;
+    }
+    LUMINA_LOG_INFO(Pipelines, "Saved pipeline cache ({} bytes) to {}", blob.size(), path);
+}
+
+void PipelineCache::Destroy() {
+    if (device) {
+        device.destroyPipelineCache(cache);
+        device = nullptr;
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "Lumina/Essence/PipelineCompiler.hpp"
+#include "Lumina/Essence/Log.hpp"
+
+
+namespace Lumina::Essence {
+
+PipelineHandle::PipelineHandle(std::shared_future<vk::Pipeline> future)
+    : future(std::move(future)) {}
+
+vk::Pipeline PipelineHandle::Get() const {
+    if (!future.valid()) {
+        return nullptr;
+    }
+    return future.get();
+}
+bool PipelineHandle::IsReady() const {
+    return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+bool PipelineHandle::HasFailed() const {
+    if (!future.valid()) {
+        return false;
+    }
+
+    try {
+        future.get();
+        return false;
+    }
+    catch (std::exception const&) {
+        return true;
+    }
+}
+void PipelineHandle::Destroy(vk::Device device) {
+    if (!future.valid()) {
+        return;
+    }
+
+    try {
+        device.destroyPipeline(future.get());
+    }
+    catch (std::exception const&) { // NOLINT(bugprone-empty-catch) a failed compilation has nothing to destroy
+    }
+    future = {};
+}
+void PipelineHandle::Retire(RetirementQueue& queue, uint64_t retireValue, char const* name) {
+    if (!future.valid()) {
+        return;
+    }
+
+    if (!HasFailed()) {
+        queue.Retire(future.get(), retireValue, name);
+    }
+    future = {};
+}
+
+
+void PipelineCompiler::Initialize(vk::Device device, PipelineCache const& pipelineCache, JobSystem& jobSystem, AssetPack const* assetPack) {
+    this->device = device;
+    this->pipelineCache = &pipelineCache;
+    this->jobSystem = &jobSystem;
+    this->assetPack = assetPack;
+}
+
+void PipelineCompiler::BypassAssetPack(std::string const& shaderPath) {
+    std::scoped_lock lock(bypassMutex);
+    bypassedShaders.insert(shaderPath);
+}
+
+vk::ShaderModule PipelineCompiler::LoadShader(std::string const& shaderPath) {
+    if (assetPack != nullptr) {
+        std::unique_lock lock(bypassMutex);
+        const bool isBypassed = bypassedShaders.contains(shaderPath);
+        lock.unlock();
+
+        if (!isBypassed) {
+            if (auto code = assetPack->Find(shaderPath)) {
+                return LoadShaderModule(*code, device);
+            }
+        }
+    }
+    return LoadShaderModule(shaderPath, device);
+}
+
+PipelineHandle PipelineCompiler::CompileCompute(std::string const& shaderPath, vk::PipelineLayout layout, std::vector<SpecializationConstant> const& constants) {
+    return Enqueue(shaderPath, [this, shaderPath, layout, constants]() {
+        vk::ShaderModule shader = LoadShader(shaderPath);
+
+        std::vector<vk::SpecializationMapEntry> mapEntries;
+        std::vector<uint32_t> data;
+        for (auto const& constant : constants) {
+            mapEntries.push_back({constant.id, static_cast<uint32_t>(data.size() * sizeof(uint32_t)), sizeof(uint32_t)});
+            data.push_back(constant.value);
+        }
+        vk::SpecializationInfo specializationInfo = {
+            static_cast<uint32_t>(mapEntries.size()), // num map entries
+            mapEntries.data(),                        // map entries
+            data.size() * sizeof(uint32_t),           // data size
+            data.data(),                              // data
+        };
+
+        vk::PipelineShaderStageCreateInfo stageInfo = {
+            {},
+            vk::ShaderStageFlagBits::eCompute,
+            shader,
+            "main",
+            constants.empty() ? nullptr : &specializationInfo,
+        };
+
+        // a dispatch can be split into parts with dispatchBase(), e.g. to record them in parallel
+        vk::ComputePipelineCreateInfo pipelineInfo = {
+            vk::PipelineCreateFlagBits::eDispatchBase,
+            stageInfo,
+            layout,
+        };
+
+        try {
+            vk::Pipeline pipeline = VkCheck(device.createComputePipeline(*pipelineCache, pipelineInfo));
+            device.destroyShaderModule(shader);
+            return pipeline;
+        }
+        catch (...) {
+            device.destroyShaderModule(shader);
+            throw;
+        }
+    });
+}
+
+PipelineHandle PipelineCompiler::CompileGraphics(PipelineBuilder builder, std::string const& vertexShaderPath, std::string const& fragmentShaderPath) {
+    return Enqueue(vertexShaderPath + " + " + fragmentShaderPath, [this, builder, vertexShaderPath, fragmentShaderPath]() mutable {
+        vk::ShaderModule vertexShader = LoadShader(vertexShaderPath);
+        vk::ShaderModule fragmentShader = LoadShader(fragmentShaderPath);
+
+        builder.SetShaders(vertexShader, fragmentShader);
+
+        try {
+            vk::Pipeline pipeline = builder.Build(device, *pipelineCache);
+            device.destroyShaderModule(vertexShader);
+            device.destroyShaderModule(fragmentShader);
+            return pipeline;
+        }
+        catch (...) {
+            device.destroyShaderModule(vertexShader);
+            device.destroyShaderModule(fragmentShader);
+            throw;
+        }
+    });
+}
+
+template <typename F>
+PipelineHandle PipelineCompiler::Enqueue(std::string const& name, F&& compile) {
+    if (numPending.fetch_add(1) == 0) {
+        batchStart = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    std::future<vk::Pipeline> future = jobSystem->SubmitLong([this, name, compile = std::forward<F>(compile)]() mutable {
+        auto finish = [&]() {
+            if (numPending.fetch_sub(1) != 1) {
+                return;
+            }
+            auto start = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(batchStart.load()));
+            auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+            LUMINA_LOG_INFO(
+                Pipelines,
+                "Pipeline compilation finished after {:.2f}ms ({} start)",
+                duration.count(),
+                pipelineCache->IsWarm() ? "warm" : "cold"
+            );
+        };
+
+        try {
+            vk::Pipeline pipeline = compile();
+            finish();
+            return pipeline;
+        }
+        catch (std::exception const& e) {
+            LUMINA_LOG_ERROR(Pipelines, "Failed to compile pipeline \"{}\": {}", name, e.what());
+            finish();
+            throw;
+        }
+    });
+
+    return PipelineHandle(future.share());
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "Lumina/Essence/ProgressiveAccumulation.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+
+namespace Lumina::Essence {
+
+ProgressiveAccumulation::Step ProgressiveAccumulation::Advance(bool inputsChanged) {
+    const bool isChangingContinuously = inputsChanged && wereInputsChanged;
+    wereInputsChanged = inputsChanged;
+
+    if (inputsChanged || !settings.enabled) {
+        numSamples = 0;
+    }
+
+    if (!settings.enabled) {
+        return {true, 0, std::max(settings.fullRenderSamples, 1u), 1};
+    }
+
+    // the samples count towards the accumulation, so it continues from there once the inputs settle
+    if (isChangingContinuously) {
+        numSamples = std::min(std::max(settings.fullRenderSamples, 1u), settings.maxSamples);
+        return {true, 0, numSamples, 1};
+    }
+
+    // the preview leaves numSamples at 0, so the next frame starts over at full resolution
+    if (inputsChanged && settings.previewScale > 1) {
+        return {true, 0, 1, settings.previewScale};
+    }
+
+    if (numSamples >= settings.maxSamples) {
+        return {};
+    }
+
+    Step step = {
+        true,
+        numSamples,
+        std::min(std::max(settings.samplesPerFrame, 1u), settings.maxSamples - numSamples),
+        1,
+    };
+    numSamples += step.numSamples;
+    return step;
+}
+
+void ProgressiveAccumulation::Reset() {
+    numSamples = 0;
+    wereInputsChanged = false;
+}
+
+
+void ProgressiveAccumulation::DrawImGui() {
+    ImGui::Begin("Progressive Rendering");
+
+    ImGui::Checkbox("Enabled", &settings.enabled);
+
+    int samplesPerFrame = static_cast<int>(settings.samplesPerFrame);
+    int maxSamples = static_cast<int>(settings.maxSamples);
+    int previewScale = static_cast<int>(settings.previewScale);
+    int fullRenderSamples = static_cast<int>(settings.fullRenderSamples);
+    if (ImGui::SliderInt("Samples per frame", &samplesPerFrame, 1, 16)) {
+        settings.samplesPerFrame = static_cast<uint32_t>(samplesPerFrame);
+    }
+    if (ImGui::SliderInt("Max samples", &maxSamples, 1, 1024)) {
+        settings.maxSamples = static_cast<uint32_t>(maxSamples);
+    }
+    if (ImGui::SliderInt("Preview scale", &previewScale, 1, 16)) {
+        settings.previewScale = static_cast<uint32_t>(previewScale);
+    }
+    if (ImGui::SliderInt("Full render samples", &fullRenderSamples, 1, 16)) {
+        settings.fullRenderSamples = static_cast<uint32_t>(fullRenderSamples);
+    }
+
+    ImGui::Text("Samples: %u / %u%s", numSamples, settings.maxSamples, IsConverged() ? " (converged)" : "");
+
+    ImGui::End();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "Lumina/Essence/RenderGraph.hpp"
+
+#include <format>
+#include <ranges>
+#include <stdexcept>
+
+namespace Lumina::Essence {
+
+RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, uint32_t passIndex)
+    : graph(graph), passIndex(passIndex) {}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::Read(ResourceId resource, Usage const& usage) {
+    return Use(resource, usage, false);
+}
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::Write(ResourceId resource, Usage const& usage) {
+    return Use(resource, usage, true);
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::SetSideEffects() {
+    graph.passes.at(passIndex).hasSideEffects = true;
+    return *this;
+}
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::SetExecute(std::function<void(vk::CommandBuffer)>&& func) {
+    graph.passes.at(passIndex).execute = std::move(func);
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::Use(ResourceId resource, Usage const& usage, bool isWrite) {
+    Pass& pass = graph.passes.at(passIndex);
+    if (resource >= graph.resources.size()) {
+        throw std::runtime_error(std::format("Pass \"{}\" uses an unknown resource", pass.name));
+    }
+
+    // a pass reading and writing the same resource only gets a single barrier for it
+    for (auto& existing : pass.usages) {
+        if (existing.resource != resource) {
+            continue;
+        }
+        if (existing.usage.layout != usage.layout) {
+            throw std::runtime_error(std::format(
+                "Pass \"{}\" uses \"{}\" in two different layouts", pass.name, graph.resources[resource].name
+            ));
+        }
+        existing.usage.stage |= usage.stage;
+        existing.usage.access |= usage.access;
+        existing.isRead |= !isWrite;
+        existing.isWrite |= isWrite;
+        return *this;
+    }
+
+    pass.usages.push_back({resource, usage, !isWrite, isWrite});
+    return *this;
+}
+
+
+void RenderGraph::Barriers::Clear() {
+    imageBarriers.clear();
+    bufferBarriers.clear();
+}
+void RenderGraph::Barriers::Record(vk::CommandBuffer cmd) const {
+    if (imageBarriers.empty() && bufferBarriers.empty()) {
+        return;
+    }
+
+    vk::DependencyInfo dependencyInfo = {
+        {},             // flags
+        nullptr,        // memory barriers
+        bufferBarriers, // buffer barriers
+        imageBarriers,  // image barriers
+    };
+    cmd.pipelineBarrier2(dependencyInfo);
+}
+
+
+void RenderGraph::Reset() {
+    resources.clear();
+    passes.clear();
+    finalBarriers.Clear();
+    numCulledPasses = 0;
+    isCompiled = false;
+}
+
+RenderGraph::ResourceId RenderGraph::ImportImage(std::string const& name, vk::Image image, vk::ImageAspectFlags aspect, Usage const& lastUsage) {
+    return AddResource({
+        name,
+        image,
+        nullptr,
+        aspect,
+        SyncState::FromLastAccess(lastUsage.stage, lastUsage.access, lastUsage.layout),
+    });
+}
+RenderGraph::ResourceId RenderGraph::ImportImage(std::string const& name, VulkanImage& image) {
+    return AddResource({name, image, nullptr, image.GetAspect(), image.GetState(), &image});
+}
+RenderGraph::ResourceId RenderGraph::ImportBuffer(std::string const& name, vk::Buffer buffer, Usage const& lastUsage) {
+    return AddResource({
+        name,
+        nullptr,
+        buffer,
+        {},
+        SyncState::FromLastAccess(lastUsage.stage, lastUsage.access, vk::ImageLayout::eUndefined),
+    });
+}
+
+RenderGraph::ResourceId RenderGraph::AddResource(Resource&& resource) {
+    resources.push_back(std::move(resource));
+    return static_cast<ResourceId>(resources.size() - 1);
+}
+
+RenderGraph::PassBuilder RenderGraph::AddPass(std::string const& name) {
+    passes.push_back({name});
+    return {*this, static_cast<uint32_t>(passes.size() - 1)};
+}
+
+void RenderGraph::SetOutput(ResourceId resource, std::optional<Usage> finalUsage) {
+    auto& output = resources.at(resource);
+    output.isOutput = true;
+    output.finalUsage = finalUsage;
+}
+
+
+void RenderGraph::Compile() {
+    CullPasses();
+
+    for (auto& pass : passes) {
+        if (pass.isCulled) {
+            continue;
+        }
+        for (auto const& usage : pass.usages) {
+            AddBarrier(resources[usage.resource], usage.usage, usage.isWrite, pass.barriers);
+        }
+    }
+
+    for (auto& resource : resources) {
+        if (resource.finalUsage) {
+            // the final usage happens outside the graph, so it counts as a read that doesn't write anything
+            AddBarrier(resource, *resource.finalUsage, false, finalBarriers);
+        }
+        if (resource.trackedImage != nullptr) {
+            resource.trackedImage->SetState(resource.state);
+        }
+    }
+
+    isCompiled = true;
+}
+
+void RenderGraph::CullPasses() {
+    std::vector<bool> isNeeded(resources.size());
+    for (size_t i = 0; i < resources.size(); i++) {
+        isNeeded[i] = resources[i].isOutput;
+    }
+
+    // walk backwards so every pass knows whether a later pass consumes what it writes
+    for (auto& pass : std::ranges::reverse_view(passes)) {
+        bool isLive = pass.hasSideEffects;
+        for (auto const& usage : pass.usages) {
+            isLive |= usage.isWrite && isNeeded[usage.resource];
+        }
+
+        pass.isCulled = !isLive;
+        if (pass.isCulled) {
+            numCulledPasses++;
+            continue;
+        }
+
+        // a plain write replaces the contents, so earlier writers aren't needed for it anymore
+        for (auto const& usage : pass.usages) {
+            if (usage.isWrite && !usage.isRead) {
+                isNeeded[usage.resource] = false;
+            }
+        }
+        for (auto const& usage : pass.usages) {
+            if (usage.isRead) {
+                isNeeded[usage.resource] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::AddBarrier(Resource& resource, Usage const& usage, bool isWrite, Barriers& barriers) {
+    auto dependency = resource.state.Access(usage.stage, usage.access, usage.layout, isWrite, static_cast<bool>(resource.image));
+    if (!dependency) {
+        return;
+    }
+
+    if (resource.image) {
+        barriers.imageBarriers.push_back({
+            dependency->srcStage,   // source stage mask
+            dependency->srcAccess,  // source access mask
+            usage.stage,            // destination stage mask
+            usage.access,           // destination access mask
+            dependency->oldLayout,  // current layout
+            usage.layout,           // new layout
+            vk::QueueFamilyIgnored, // source queue family index
+            vk::QueueFamilyIgnored, // dest queue family index
+            resource.image,
+            CreateSubresourceRangeForAllLayers(resource.aspect),
+        });
+    }
+    else {
+        barriers.bufferBarriers.push_back({
+            dependency->srcStage,   // source stage mask
+            dependency->srcAccess,  // source access mask
+            usage.stage,            // destination stage mask
+            usage.access,           // destination access mask
+            vk::QueueFamilyIgnored, // source queue family index
+            vk::QueueFamilyIgnored, // dest queue family index
+            resource.buffer,
+            0,             // offset
+            vk::WholeSize, // size
+        });
+    }
+}
+
+
+void RenderGraph::Execute(vk::CommandBuffer cmd, GpuProfiler& profiler) {
+    if (!isCompiled) {
+        Compile();
+    }
+
+    for (auto const& pass : passes) {
+        if (pass.isCulled) {
+            continue;
+        }
+
+        pass.barriers.Record(cmd);
+        if (pass.execute) {
+            auto zone = profiler.Scope(cmd, pass.name);
+            pass.execute(cmd);
+        }
+    }
+
+    finalBarriers.Record(cmd);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "Lumina/Essence/RetirementQueue.hpp"
+#include "Lumina/Essence/Log.hpp"
+
+
+namespace Lumina::Essence {
+
+namespace {
+
+// enough for a few frames of transient resources before the arrays have to grow
+constexpr size_t initialCapacity = 256;
+
+}
+
+void RetirementQueue::Initialize(vk::Device device, VmaAllocator allocator) {
+    this->device = device;
+    this->allocator = allocator;
+
+    pipelines.reserve(initialCapacity);
+    imageViews.reserve(initialCapacity);
+    images.reserve(initialCapacity);
+    buffers.reserve(initialCapacity);
+    swapchains.reserve(initialCapacity);
+}
+
+void RetirementQueue::Retire(vk::Pipeline pipeline, uint64_t retireValue, char const* name) {
+    Push(pipelines, pipeline, retireValue, name);
+}
+void RetirementQueue::Retire(vk::ImageView imageView, uint64_t retireValue, char const* name) {
+    Push(imageViews, imageView, retireValue, name);
+}
+void RetirementQueue::Retire(vk::Image image, VmaAllocation allocation, uint64_t retireValue, char const* name) {
+    Push(images, {image, allocation}, retireValue, name);
+}
+void RetirementQueue::Retire(vk::Buffer buffer, VmaAllocation allocation, uint64_t retireValue, char const* name) {
+    Push(buffers, {buffer, allocation}, retireValue, name);
+}
+void RetirementQueue::Retire(vk::SwapchainKHR swapchain, uint64_t retireValue, char const* name) {
+    Push(swapchains, swapchain, retireValue, name);
+}
+
+template <typename Handle>
+void RetirementQueue::Push(std::vector<Entry<Handle>>& entries, Handle handle, uint64_t retireValue, [[maybe_unused]] char const* name) {
+#if defined(LUMINA_DEBUG)
+    entries.push_back({handle, retireValue, name});
+#else
+    entries.push_back({handle, retireValue});
+#endif
+}
+
+
+void RetirementQueue::Collect(uint64_t completedValue) {
+    Collect(completedValue, false);
+}
+void RetirementQueue::DestroyAll() {
+    Collect(UINT64_MAX, BuildMode::Current == BuildMode::Debug);
+}
+
+void RetirementQueue::Collect(uint64_t completedValue, bool isLogging) {
+    // views before the images they look at, pipelines and swapchains don't depend on anything here
+    Collect(pipelines, completedValue, isLogging, [this](vk::Pipeline pipeline) { device.destroyPipeline(pipeline); });
+    Collect(imageViews, completedValue, isLogging, [this](vk::ImageView imageView) { device.destroyImageView(imageView); });
+    Collect(images, completedValue, isLogging, [this](AllocatedImage image) {
+        vmaDestroyImage(allocator, image.image, image.allocation);
+    });
+    Collect(buffers, completedValue, isLogging, [this](AllocatedBuffer buffer) {
+        vmaDestroyBuffer(allocator, buffer.buffer, buffer.allocation);
+    });
+    Collect(swapchains, completedValue, isLogging, [this](vk::SwapchainKHR swapchain) { device.destroySwapchainKHR(swapchain); });
+}
+
+template <typename Handle, typename F>
+void RetirementQueue::Collect(std::vector<Entry<Handle>>& entries, uint64_t completedValue, [[maybe_unused]] bool isLogging, F&& destroy) {
+    size_t numKept = 0;
+    for (auto& entry : entries) {
+        if (entry.retireValue > completedValue) {
+            entries[numKept++] = entry;
+            continue;
+        }
+
+        destroy(entry.handle);
+#if defined(LUMINA_DEBUG)
+        if (isLogging && entry.name != nullptr) {
+            LUMINA_LOG_DEBUG(Resources, "Deleted {}", entry.name);
+        }
+#endif
+    }
+    // never shrinks the capacity
+    entries.resize(numKept);
+}
+
+size_t RetirementQueue::GetNumPending() const {
+    return pipelines.size() + imageViews.size() + images.size() + buffers.size() + swapchains.size();
+}
+
+}
\ No newline at end of file
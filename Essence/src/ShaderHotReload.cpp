@@ -0,0 +1,150 @@
+#include "Lumina/Essence/ShaderHotReload.hpp"
+#include "Lumina/Essence/Utils/Platform.hpp"
+#include "Lumina/Essence/Log.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+#if defined(LUMINA_PLATFORM_LINUX)
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace Lumina::Essence {
+
+namespace {
+
+bool IsShaderSource(std::filesystem::path const& path) {
+    auto extension = path.extension();
+    return extension == ".vert" || extension == ".frag" || extension == ".comp";
+}
+
+#if defined(LUMINA_PLATFORM_LINUX)
+// Editors save in bursts (truncate, write, rename), so changes are collected until the directory was
+// quiet for this long before anything is compiled.
+constexpr int settleTimeMs = 50;
+// how often the watcher checks whether it should stop
+constexpr int pollTimeoutMs = 100;
+#endif
+
+}
+
+ShaderHotReload::~ShaderHotReload() {
+    Destroy();
+}
+
+void ShaderHotReload::Initialize(std::filesystem::path const& directory, std::string const& glslcPath, JobSystem& jobSystem) {
+    this->directory = directory;
+    this->glslcPath = glslcPath;
+    this->jobSystem = &jobSystem;
+
+#if defined(LUMINA_PLATFORM_LINUX)
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        throw std::runtime_error("Failed to initialize inotify!");
+    }
+    // IN_CLOSE_WRITE for editors writing in place, IN_MOVED_TO for ones renaming a temporary file
+    if (inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(inotifyFd);
+        inotifyFd = -1;
+        throw std::runtime_error(std::format("Failed to watch directory \"{}\"!", directory.string()));
+    }
+
+    isStopping = false;
+    watcher = std::thread([this]() { WatchLoop(); });
+    LUMINA_LOG_INFO(Pipelines, "Watching {} for shader changes", directory.string());
+#else
+    LUMINA_LOG_WARNING(Pipelines, "Shader hot reload is only supported on Linux");
+#endif
+}
+
+void ShaderHotReload::Destroy() {
+    isStopping = true;
+    if (watcher.joinable()) {
+        watcher.join();
+    }
+    // the jobs write into this object
+    if (jobSystem != nullptr) {
+        jobSystem->Wait(compileJobs);
+    }
+
+#if defined(LUMINA_PLATFORM_LINUX)
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+#endif
+}
+
+std::vector<std::string> ShaderHotReload::TakeRecompiledShaders() {
+    std::scoped_lock lock(mutex);
+    return std::exchange(recompiledShaders, {});
+}
+
+
+void ShaderHotReload::WatchLoop() {
+#if defined(LUMINA_PLATFORM_LINUX)
+    alignas(inotify_event) std::array<char, 4096> buffer;
+    std::set<std::string> changedSources;
+
+    while (!isStopping) {
+        pollfd pollInfo = {inotifyFd, POLLIN, 0};
+        const int timeout = changedSources.empty() ? pollTimeoutMs : settleTimeMs;
+        if (poll(&pollInfo, 1, timeout) <= 0) {
+            // Quiet for long enough, compile everything that piled up. Not waited for here, helping out with
+            // other jobs on this thread could pick up ones that must run on a worker or the frame thread.
+            if (!changedSources.empty() && compileJobs.IsDone()) {
+                for (auto const& source : changedSources) {
+                    jobSystem->RunLong([this, source]() { Compile(source); }, &compileJobs);
+                }
+                changedSources.clear();
+            }
+            continue;
+        }
+
+        ssize_t length = 0;
+        while ((length = read(inotifyFd, buffer.data(), buffer.size())) > 0) {
+            for (ssize_t offset = 0; offset < length;) {
+                auto const* event = reinterpret_cast<inotify_event const*>(buffer.data() + offset); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) that's how inotify hands them out
+                if (event->len > 0 && IsShaderSource(event->name)) {
+                    changedSources.insert(event->name);
+                }
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            }
+        }
+    }
+#endif
+}
+
+bool ShaderHotReload::Compile(std::string const& sourceName) {
+    const auto source = directory / sourceName;
+    const auto target = directory / (sourceName + ".spv");
+    const auto temporaryTarget = directory / (sourceName + ".spv.tmp");
+
+    auto start = std::chrono::steady_clock::now();
+
+    // glslc prints its own errors, and writing to a temporary file keeps the old SPIR-V on failure
+    const std::string command = std::format("\"{}\" -o \"{}\" \"{}\"", glslcPath, temporaryTarget.string(), source.string());
+    if (std::system(command.c_str()) != 0) {
+        LUMINA_LOG_WARNING(Pipelines, "Failed to recompile shader \"{}\", keeping the old one", source.string());
+        std::error_code error;
+        std::filesystem::remove(temporaryTarget, error);
+        return false;
+    }
+    std::filesystem::rename(temporaryTarget, target);
+
+    auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    LUMINA_LOG_INFO(Pipelines, "Recompiled shader \"{}\" in {:.2f}ms", source.string(), duration.count());
+
+    std::scoped_lock lock(mutex);
+    recompiledShaders.push_back(target.generic_string());
+    return true;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "Lumina/Essence/StagingRing.hpp"
+
+#include <cstring>
+
+namespace Lumina::Essence {
+
+void StagingRing::Initialize(Application& app, vk::DeviceSize bytesPerFrame, uint32_t numFrames) {
+    this->bytesPerFrame = bytesPerFrame;
+
+    buffer = VulkanBuffer(
+        app,
+        bytesPerFrame * numFrames,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        VMA_MEMORY_USAGE_AUTO,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+    );
+}
+void StagingRing::Destroy() {
+    buffer.Destroy();
+}
+
+void StagingRing::BeginFrame(uint32_t frameIndex) {
+    regionBegin = bytesPerFrame * frameIndex;
+    offset = regionBegin;
+    hasPendingCopies = false;
+}
+
+std::optional<StagingRing::Allocation> StagingRing::Allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+    vk::DeviceSize alignedOffset = (offset + alignment - 1) / alignment * alignment;
+    if (alignedOffset + size > regionBegin + bytesPerFrame) {
+        return std::nullopt;
+    }
+    offset = alignedOffset + size;
+
+    return Allocation{
+        static_cast<std::byte*>(buffer.GetMappedData()) + alignedOffset,
+        buffer,
+        alignedOffset,
+        size,
+    };
+}
+
+bool StagingRing::Upload(vk::CommandBuffer cmd, vk::Buffer target, vk::DeviceSize targetOffset, std::span<const std::byte> data) {
+    auto allocation = Allocate(data.size());
+    if (!allocation) {
+        return false;
+    }
+
+    std::memcpy(allocation->mappedData, data.data(), data.size());
+    buffer.FlushMappedRange(allocation->offset, allocation->size);
+
+    vk::BufferCopy2 region = {
+        allocation->offset, // source offset
+        targetOffset,       // destination offset
+        data.size(),        // size
+    };
+    cmd.copyBuffer2({buffer, target, region});
+
+    hasPendingCopies = true;
+    return true;
+}
+
+bool StagingRing::Upload(vk::CommandBuffer cmd, VulkanImage& target, vk::Extent3D extent, std::span<const std::byte> data) {
+    auto allocation = Allocate(data.size());
+    if (!allocation) {
+        return false;
+    }
+
+    std::memcpy(allocation->mappedData, data.data(), data.size());
+    buffer.FlushMappedRange(allocation->offset, allocation->size);
+
+    vk::ImageSubresourceRange range = {
+        target.GetAspect(), // aspect mask
+        0,                  // base mip level
+        1,                  // num mip levels
+        0,                  // base array layer
+        1,                  // num array layers
+    };
+    target.TransitionTo(
+        cmd, vk::ImageLayout::eTransferDstOptimal, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite, range
+    );
+
+    // clang-format off
+    vk::BufferImageCopy2 region = {
+        allocation->offset, // source offset
+        0,                  // source row length, 0 means tightly packed
+        0,                  // source image height, 0 means tightly packed
+        vk::ImageSubresourceLayers{
+            target.GetAspect(),              // aspect mask
+            0,                               // mip level
+            0,                               // base array layer
+            1,                               // num array layers
+        },
+        vk::Offset3D{},     // destination offset
+        extent,             // destination extent
+    };
+    // clang-format on
+    cmd.copyBufferToImage2({buffer, target, vk::ImageLayout::eTransferDstOptimal, region});
+
+    hasPendingCopies = true;
+    return true;
+}
+
+void StagingRing::FlushBarrier(vk::CommandBuffer cmd) {
+    if (!hasPendingCopies) {
+        return;
+    }
+
+    vk::MemoryBarrier2 barrier = {
+        vk::PipelineStageFlagBits2::eCopy,        // source stage mask
+        vk::AccessFlagBits2::eTransferWrite,      // source access mask
+        vk::PipelineStageFlagBits2::eAllCommands, // destination stage mask
+        vk::AccessFlagBits2::eMemoryRead,         // destination access mask
+    };
+    cmd.pipelineBarrier2({{}, barrier});
+
+    hasPendingCopies = false;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "Lumina/Essence/SyncState.hpp"
+
+namespace Lumina::Essence {
+
+namespace {
+
+constexpr vk::AccessFlags2 writeAccessMask = vk::AccessFlagBits2::eShaderWrite
+                                           | vk::AccessFlagBits2::eShaderStorageWrite
+                                           | vk::AccessFlagBits2::eColorAttachmentWrite
+                                           | vk::AccessFlagBits2::eDepthStencilAttachmentWrite
+                                           | vk::AccessFlagBits2::eTransferWrite
+                                           | vk::AccessFlagBits2::eHostWrite
+                                           | vk::AccessFlagBits2::eMemoryWrite;
+
+}
+
+SyncState SyncState::FromLastAccess(vk::PipelineStageFlags2 stage, vk::AccessFlags2 access, vk::ImageLayout layout) {
+    SyncState state;
+    state.layout = layout;
+    state.writeStage = stage;
+    state.writeAccess = access & writeAccessMask;
+    return state;
+}
+
+std::optional<Dependency> SyncState::Access(vk::PipelineStageFlags2 stage, vk::AccessFlags2 access, vk::ImageLayout newLayout, bool isWrite, bool tracksLayout) {
+    const vk::ImageLayout oldLayout = layout;
+    const bool isLayoutChange = tracksLayout && newLayout != oldLayout;
+
+    if (isLayoutChange || isWrite) {
+        // wait for the last write and for everyone reading it, a layout transition counts as a write
+        Dependency dependency = {writeStage | readStages, writeAccess, oldLayout};
+
+        if (isLayoutChange) {
+            layout = newLayout;
+        }
+        writeStage = stage;
+        writeAccess = isWrite ? access & writeAccessMask : vk::AccessFlagBits2::eNone;
+        readStages = vk::PipelineStageFlagBits2::eNone;
+        // nobody has seen the new contents yet, not even later accesses of the same stage
+        visibleStages = vk::PipelineStageFlagBits2::eNone;
+        visibleAccess = vk::AccessFlagBits2::eNone;
+
+        if (!isLayoutChange && !dependency.srcStage) {
+            return std::nullopt;
+        }
+        return dependency;
+    }
+
+    readStages |= stage;
+
+    // reads only need a barrier if the last write isn't visible to them yet
+    const bool isVisible = (stage & ~visibleStages) == vk::PipelineStageFlags2{}
+                        && (access & ~visibleAccess) == vk::AccessFlags2{};
+    if (!writeStage || isVisible) {
+        return std::nullopt;
+    }
+
+    visibleStages |= stage;
+    visibleAccess |= access;
+    return Dependency{writeStage, writeAccess, oldLayout};
+}
+
+
+bool IsWriteAccess(vk::AccessFlags2 access) {
+    return static_cast<bool>(access & writeAccessMask);
+}
+
+}
\ No newline at end of file
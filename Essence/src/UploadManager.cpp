@@ -0,0 +1,283 @@
+#include "Lumina/Essence/UploadManager.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Lumina::Essence {
+
+void UploadManager::Initialize(Application& app, vk::Device device, vk::Queue transferQueue, uint32_t transferQueueFamily, uint32_t graphicsQueueFamily) {
+    this->app = &app;
+    this->device = device;
+    this->transferQueue = transferQueue;
+    this->transferQueueFamily = transferQueueFamily;
+    this->graphicsQueueFamily = graphicsQueueFamily;
+
+    vk::CommandPoolCreateInfo poolInfo = {{vk::CommandPoolCreateFlagBits::eResetCommandBuffer}, transferQueueFamily};
+    commandPool = device.createCommandPool(poolInfo);
+
+    vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo> timelineInfo = {
+        {},
+        {vk::SemaphoreType::eTimeline, 0},
+    };
+    timeline = device.createSemaphore(timelineInfo.get<vk::SemaphoreCreateInfo>());
+}
+void UploadManager::Destroy() {
+    if (!device) {
+        return;
+    }
+
+    WaitOnHost({lastSubmittedValue});
+    openBatch.reset();
+    submittedBatches.clear();
+    pendingAcquires.clear();
+    freeStagingChunks.clear();
+
+    device.destroySemaphore(timeline);
+    device.destroyCommandPool(commandPool);
+    device = nullptr;
+}
+
+
+void UploadManager::UploadBuffer(vk::Buffer target, vk::DeviceSize targetOffset, std::span<const std::byte> data) {
+    BeginBatch();
+    auto [stagingBuffer, stagingOffset] = Stage(data);
+
+    vk::BufferCopy2 region = {
+        stagingOffset, // source offset
+        targetOffset,  // destination offset
+        data.size(),   // size
+    };
+    openBatch->cmd.copyBuffer2({stagingBuffer, target, region});
+
+    if (!NeedsOwnershipTransfer()) {
+        return;
+    }
+
+    // the acquire has to match the release exactly, apart from the stage and access masks
+    vk::BufferMemoryBarrier2 release = {
+        vk::PipelineStageFlagBits2::eCopy,   // source stage mask
+        vk::AccessFlagBits2::eTransferWrite, // source access mask
+        vk::PipelineStageFlagBits2::eNone,   // destination stage mask, ignored for a release
+        vk::AccessFlagBits2::eNone,          // destination access mask, ignored for a release
+        transferQueueFamily,                 // source queue family index
+        graphicsQueueFamily,                 // dest queue family index
+        target,
+        targetOffset,
+        data.size(),
+    };
+    vk::BufferMemoryBarrier2 acquire = release;
+    acquire.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+    acquire.srcAccessMask = vk::AccessFlagBits2::eNone;
+    acquire.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+    acquire.dstAccessMask = vk::AccessFlagBits2::eMemoryRead;
+
+    openBatch->releaseBufferBarriers.push_back(release);
+    openBatch->acquire.bufferBarriers.push_back(acquire);
+}
+
+void UploadManager::UploadImage(VulkanImage& target, vk::Extent3D extent, std::span<const std::byte> data, vk::ImageLayout finalLayout) {
+    BeginBatch();
+    auto [stagingBuffer, stagingOffset] = Stage(data);
+
+    vk::ImageSubresourceRange range = CreateSubresourceRangeForAllLayers(target.GetAspect());
+
+    // the transfer queue doesn't own the image, so it can't keep what was in there
+    if (NeedsOwnershipTransfer()) {
+        target.SetState({});
+    }
+    target.TransitionTo(
+        openBatch->cmd, vk::ImageLayout::eTransferDstOptimal, vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite, range
+    );
+
+    // clang-format off
+    vk::BufferImageCopy2 region = {
+        stagingOffset, // source offset
+        0,             // source row length, 0 means tightly packed
+        0,             // source image height, 0 means tightly packed
+        vk::ImageSubresourceLayers{
+            target.GetAspect(), // aspect mask
+            0,                  // mip level
+            0,                  // base array layer
+            1,                  // num array layers
+        },
+        vk::Offset3D{}, // destination offset
+        extent,         // destination extent
+    };
+    // clang-format on
+    openBatch->cmd.copyBufferToImage2({stagingBuffer, target, vk::ImageLayout::eTransferDstOptimal, region});
+
+    // the layout transition happens as part of the release and acquire pair
+    SyncState const& copyState = target.GetState();
+    vk::ImageMemoryBarrier2 release = {
+        copyState.writeStage,              // source stage mask
+        copyState.writeAccess,             // source access mask
+        vk::PipelineStageFlagBits2::eNone, // destination stage mask
+        vk::AccessFlagBits2::eNone,        // destination access mask
+        copyState.layout,                  // current layout
+        finalLayout,                       // new layout
+        vk::QueueFamilyIgnored,            // source queue family index
+        vk::QueueFamilyIgnored,            // dest queue family index
+        target,
+        range,
+    };
+
+    // the graphics queue first sees the image after waiting for the batch, treat the whole upload as one write
+    const vk::PipelineStageFlags2 acquireStage = vk::PipelineStageFlagBits2::eAllCommands;
+    target.SetState(SyncState::FromLastAccess(acquireStage, vk::AccessFlagBits2::eMemoryWrite, finalLayout));
+
+    if (!NeedsOwnershipTransfer()) {
+        // the semaphore wait on the graphics queue makes the transition visible, no acquire needed
+        openBatch->releaseImageBarriers.push_back(release);
+        return;
+    }
+
+    release.srcQueueFamilyIndex = transferQueueFamily;
+    release.dstQueueFamilyIndex = graphicsQueueFamily;
+
+    vk::ImageMemoryBarrier2 acquire = release;
+    acquire.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+    acquire.srcAccessMask = vk::AccessFlagBits2::eNone;
+    acquire.dstStageMask = acquireStage;
+    acquire.dstAccessMask = vk::AccessFlagBits2::eMemoryRead;
+
+    openBatch->releaseImageBarriers.push_back(release);
+    openBatch->acquire.imageBarriers.push_back(acquire);
+}
+
+
+UploadToken UploadManager::Submit() {
+    if (!openBatch) {
+        return {lastSubmittedValue};
+    }
+
+    Batch& batch = *openBatch;
+    if (!batch.releaseBufferBarriers.empty() || !batch.releaseImageBarriers.empty()) {
+        batch.cmd.pipelineBarrier2({{}, {}, batch.releaseBufferBarriers, batch.releaseImageBarriers});
+    }
+    batch.cmd.end();
+
+    batch.value = ++lastSubmittedValue;
+
+    vk::CommandBufferSubmitInfo submitInfo = {batch.cmd};
+    vk::SemaphoreSubmitInfo signalInfo = {timeline, batch.value, vk::PipelineStageFlagBits2::eAllCommands};
+    transferQueue.submit2(vk::SubmitInfo2{{}, {}, submitInfo, signalInfo});
+
+    // kept apart from the batch, the frame using the upload may come long after the batch completed
+    if (!batch.acquire.bufferBarriers.empty() || !batch.acquire.imageBarriers.empty()) {
+        batch.acquire.value = batch.value;
+        pendingAcquires.push_back(std::move(batch.acquire));
+    }
+
+    submittedBatches.push_back(std::move(batch));
+    openBatch.reset();
+
+    return {lastSubmittedValue};
+}
+
+bool UploadManager::IsComplete(UploadToken token) const {
+    return device.getSemaphoreCounterValue(timeline) >= token.value;
+}
+void UploadManager::WaitOnHost(UploadToken token) const {
+    if (token.value == 0) {
+        return;
+    }
+
+    vk::SemaphoreWaitInfo waitInfo = {{}, timeline, token.value};
+    VkCheck(device.waitSemaphores(waitInfo, UINT64_MAX));
+}
+
+vk::SemaphoreSubmitInfo UploadManager::Acquire(vk::CommandBuffer cmd, UploadToken token) {
+    std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+    std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+
+    while (!pendingAcquires.empty() && pendingAcquires.front().value <= token.value) {
+        auto const& acquire = pendingAcquires.front();
+        bufferBarriers.insert(bufferBarriers.end(), acquire.bufferBarriers.begin(), acquire.bufferBarriers.end());
+        imageBarriers.insert(imageBarriers.end(), acquire.imageBarriers.begin(), acquire.imageBarriers.end());
+        pendingAcquires.pop_front();
+    }
+
+    if (!bufferBarriers.empty() || !imageBarriers.empty()) {
+        cmd.pipelineBarrier2({{}, {}, bufferBarriers, imageBarriers});
+    }
+
+    return {timeline, token.value, vk::PipelineStageFlagBits2::eAllCommands};
+}
+
+void UploadManager::CollectCompleted() {
+    if (submittedBatches.empty()) {
+        return;
+    }
+
+    uint64_t completedValue = device.getSemaphoreCounterValue(timeline);
+    while (!submittedBatches.empty() && submittedBatches.front().value <= completedValue) {
+        Batch& batch = submittedBatches.front();
+        freeCommandBuffers.push_back(batch.cmd);
+
+        // oversized buffers of single big uploads aren't worth keeping around
+        for (auto& staging : batch.stagingBuffers) {
+            if (staging.GetSize() == stagingChunkSize && freeStagingChunks.size() < maxFreeStagingChunks) {
+                freeStagingChunks.push_back(std::move(staging));
+            }
+        }
+        submittedBatches.pop_front();
+    }
+}
+
+
+void UploadManager::BeginBatch() {
+    if (openBatch) {
+        return;
+    }
+
+    openBatch.emplace();
+
+    if (freeCommandBuffers.empty()) {
+        openBatch->cmd = device.allocateCommandBuffers({commandPool, vk::CommandBufferLevel::ePrimary, 1})[0];
+    }
+    else {
+        openBatch->cmd = freeCommandBuffers.back();
+        freeCommandBuffers.pop_back();
+        openBatch->cmd.reset();
+    }
+
+    openBatch->cmd.begin({{vk::CommandBufferUsageFlagBits::eOneTimeSubmit}});
+}
+
+std::pair<vk::Buffer, vk::DeviceSize> UploadManager::Stage(std::span<const std::byte> data) {
+    Batch& batch = *openBatch;
+
+    constexpr vk::DeviceSize alignment = 16;
+    vk::DeviceSize offset = (batch.chunkOffset + alignment - 1) / alignment * alignment;
+
+    // uploads are packed into shared chunks, bigger ones get a buffer of their own
+    if (batch.stagingBuffers.empty() || offset + data.size() > batch.stagingBuffers.back().GetSize()) {
+        if (data.size() <= stagingChunkSize && !freeStagingChunks.empty()) {
+            batch.stagingBuffers.push_back(std::move(freeStagingChunks.back()));
+            freeStagingChunks.pop_back();
+        }
+        else {
+            batch.stagingBuffers.emplace_back(
+                *app,
+                std::max(stagingChunkSize, static_cast<vk::DeviceSize>(data.size())),
+                vk::BufferUsageFlagBits::eTransferSrc,
+                VMA_MEMORY_USAGE_AUTO,
+                VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+            );
+        }
+        offset = 0;
+    }
+
+    VulkanBuffer& staging = batch.stagingBuffers.back();
+    std::memcpy(static_cast<std::byte*>(staging.GetMappedData()) + offset, data.data(), data.size());
+    staging.FlushMappedRange(offset, data.size());
+
+    batch.chunkOffset = offset + data.size();
+    return {staging, offset};
+}
+
+bool UploadManager::NeedsOwnershipTransfer() const {
+    return transferQueueFamily != graphicsQueueFamily;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "Lumina/Essence/Utils/AssetPack.hpp"
+#include "Lumina/Essence/Utils/FileIO.hpp"
+#include "Lumina/Essence/Utils/Hash.hpp"
+#include "Lumina/Essence/Utils/Packed.hpp"
+#include "Lumina/Essence/Utils/Platform.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#if !defined(LUMINA_PLATFORM_WINDOWS)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Lumina::Essence {
+
+namespace {
+
+constexpr uint32_t packMagic = 0x4b504d4c; // "LMPK"
+constexpr uint32_t packVersion = 1;
+
+LUMINA_PACKED(struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numEntries;
+    uint32_t alignment;
+    uint64_t indexHash; // of the entries and names
+});
+
+uint64_t HashName(std::string_view name) {
+    return Fnv1a64({reinterpret_cast<uint8_t const*>(name.data()), name.size()}); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) bytes of the string
+}
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+LUMINA_PACKED(struct AssetPack::Entry {
+    uint64_t nameHash;
+    uint64_t offset; // from the start of the pack
+    uint64_t size;
+    uint64_t contentHash;
+    uint32_t nameOffset; // from the start of the name table
+    uint32_t nameLength;
+});
+
+AssetPack::~AssetPack() {
+    Close();
+}
+
+void AssetPack::Open(std::filesystem::path const& path) {
+    Close();
+
+#if defined(LUMINA_PLATFORM_WINDOWS)
+    fallbackBytes = ReadBinaryFile(path.string());
+    mapping = fallbackBytes;
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(std::format("Failed to open asset pack \"{}\"!", path.string()));
+    }
+
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+        close(fd);
+        throw std::runtime_error(std::format("Failed to read asset pack \"{}\"!", path.string()));
+    }
+
+    // the mapping keeps the file alive on its own
+    void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error(std::format("Failed to map asset pack \"{}\"!", path.string()));
+    }
+    mapping = {static_cast<uint8_t const*>(data), static_cast<size_t>(fileStat.st_size)};
+#endif
+
+    prefix = path.parent_path().generic_string();
+    if (!prefix.empty()) {
+        prefix += "/";
+    }
+
+    try {
+        Validate();
+    }
+    catch (...) {
+        Close();
+        throw;
+    }
+}
+
+void AssetPack::Close() {
+#if !defined(LUMINA_PLATFORM_WINDOWS)
+    if (!mapping.empty()) {
+        munmap(const_cast<uint8_t*>(mapping.data()), mapping.size()); // NOLINT(cppcoreguidelines-pro-type-const-cast) munmap doesn't take a const pointer
+    }
+#endif
+    mapping = {};
+    fallbackBytes.clear();
+}
+
+void AssetPack::Validate() const {
+    Header header = {};
+    if (mapping.size() < sizeof(header)) {
+        throw std::runtime_error("Asset pack is truncated!");
+    }
+    std::memcpy(&header, mapping.data(), sizeof(header));
+
+    if (header.magic != packMagic || header.version != packVersion) {
+        throw std::runtime_error("Asset pack has an unknown format!");
+    }
+    if (header.alignment == 0 || header.alignment % 4 != 0) {
+        throw std::runtime_error("Asset pack has an invalid alignment!");
+    }
+    if (mapping.size() < sizeof(header) + uint64_t(header.numEntries) * sizeof(Entry)) {
+        throw std::runtime_error("Asset pack index is truncated!");
+    }
+
+    // only the extent of the name table is needed to hash the index, both halves are 32 bit so it can't overflow
+    auto entries = GetEntries();
+    uint64_t namesEnd = 0;
+    for (auto const& entry : entries) {
+        namesEnd = std::max(namesEnd, uint64_t(entry.nameOffset) + entry.nameLength);
+    }
+
+    const uint64_t indexSize = entries.size_bytes() + namesEnd;
+    if (indexSize > mapping.size() - sizeof(header)
+        || Fnv1a64(mapping.subspan(sizeof(header), indexSize)) != header.indexHash) {
+        throw std::runtime_error("Asset pack index is corrupted!");
+    }
+
+    // written this way around so a huge offset or size can't wrap past the check
+    for (auto const& entry : entries) {
+        if (entry.offset > mapping.size() || entry.size > mapping.size() - entry.offset || entry.offset % header.alignment != 0) {
+            throw std::runtime_error("Asset pack has an entry outside of the file!");
+        }
+    }
+
+    // touches every page, so only where catching a broken pack matters more than startup time
+    if constexpr (BuildMode::Current == BuildMode::Debug) {
+        for (auto const& entry : entries) {
+            if (Fnv1a64(mapping.subspan(entry.offset, entry.size)) != entry.contentHash) {
+                throw std::runtime_error("Asset pack content is corrupted!");
+            }
+        }
+    }
+}
+
+std::span<const AssetPack::Entry> AssetPack::GetEntries() const {
+    Header header = {};
+    std::memcpy(&header, mapping.data(), sizeof(header));
+    // entries are packed, so they can be read in place whatever their alignment
+    return {reinterpret_cast<Entry const*>(mapping.data() + sizeof(header)), header.numEntries}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) the index is stored as is
+}
+
+std::optional<std::span<const uint8_t>> AssetPack::Find(std::string_view path) const {
+    if (!IsOpen() || !path.starts_with(prefix)) {
+        return std::nullopt;
+    }
+    std::string_view name = path.substr(prefix.size());
+    const uint64_t nameHash = HashName(name);
+
+    auto entries = GetEntries();
+    auto names = mapping.subspan(sizeof(Header) + entries.size_bytes());
+
+    // entries are sorted by hash, collisions are told apart by the stored name
+    auto it = std::ranges::lower_bound(entries, nameHash, {}, &Entry::nameHash);
+    for (; it != entries.end() && it->nameHash == nameHash; it++) {
+        std::string_view entryName(reinterpret_cast<char const*>(names.data() + it->nameOffset), it->nameLength); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) names are stored as bytes
+        if (entryName == name) {
+            return mapping.subspan(it->offset, it->size);
+        }
+    }
+    return std::nullopt;
+}
+
+
+void AssetPack::Write(std::filesystem::path const& path, std::vector<File> const& files, uint32_t alignment) {
+    if (alignment == 0 || alignment % 4 != 0) {
+        throw std::invalid_argument(std::format("Asset pack alignment has to be a multiple of 4, but is {}", alignment));
+    }
+
+    std::vector<File const*> sortedFiles;
+    for (auto const& file : files) {
+        sortedFiles.push_back(&file);
+    }
+    std::ranges::sort(sortedFiles, {}, [](File const* file) { return HashName(file->name); });
+
+    std::vector<Entry> entries;
+    std::string names;
+    for (File const* file : sortedFiles) {
+        entries.push_back({
+            HashName(file->name),
+            0,
+            file->bytes.size(),
+            Fnv1a64(file->bytes),
+            static_cast<uint32_t>(names.size()),
+            static_cast<uint32_t>(file->name.size()),
+        });
+        names += file->name;
+    }
+
+    // contents follow the index
+    uint64_t offset = sizeof(Header) + entries.size() * sizeof(Entry) + names.size();
+    for (size_t i = 0; i < entries.size(); i++) {
+        offset = AlignUp(offset, alignment);
+        entries[i].offset = offset;
+        offset += entries[i].size;
+    }
+
+    std::vector<uint8_t> bytes(offset);
+    uint8_t* index = bytes.data() + sizeof(Header);
+    std::memcpy(index, entries.data(), entries.size() * sizeof(Entry));
+    std::memcpy(index + entries.size() * sizeof(Entry), names.data(), names.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        std::ranges::copy(sortedFiles[i]->bytes, bytes.begin() + static_cast<ptrdiff_t>(entries[i].offset));
+    }
+
+    Header header = {
+        packMagic,
+        packVersion,
+        static_cast<uint32_t>(entries.size()),
+        alignment,
+        Fnv1a64({index, entries.size() * sizeof(Entry) + names.size()}),
+    };
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    WriteBinaryFileAtomically(path.string(), bytes);
+}
+
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <fstream>
 #include <format>
+#include <filesystem>
 
 namespace Lumina::Essence {
 
@@ -21,4 +22,21 @@ std::vector<uint8_t> ReadBinaryFile(std::string const& path) {
     return bytes;
 }
 
+void WriteBinaryFileAtomically(std::string const& path, std::span<const uint8_t> bytes) {
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error(std::format("Failed to open file \"{}\"!", temporaryPath));
+        }
+
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) there is no other way
+        if (!file.good()) {
+            throw std::runtime_error(std::format("Failed to write file \"{}\"!", temporaryPath));
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, path);
+}
+
 }
\ No newline at end of file
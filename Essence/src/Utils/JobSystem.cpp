@@ -0,0 +1,265 @@
+#include "Lumina/Essence/Utils/JobSystem.hpp"
+#include "Lumina/Essence/Utils/ScopeGuard.hpp"
+#include "Lumina/Essence/Log.hpp"
+
+#include <exception>
+#include <utility>
+
+namespace Lumina::Essence {
+
+namespace {
+
+// index of the worker the current thread is, if it belongs to `currentSystem`
+thread_local JobSystem const* currentSystem = nullptr;
+thread_local uint32_t currentWorker = 0;
+
+}
+
+JobSystem::JobSystem(uint32_t numThreads) {
+    numThreads = std::max(numThreads, 1u);
+    maxRunningLongJobs = std::max(numThreads - 1, 1u);
+
+    queues.reserve(numThreads);
+    for (uint32_t i = 0; i < numThreads; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    workers.reserve(numThreads);
+    for (uint32_t i = 0; i < numThreads; i++) {
+        workers.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::scoped_lock lock(sleepMutex);
+        isStopping = true;
+    }
+    jobAvailable.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+
+void JobSystem::Push(Job&& job) {
+    const bool isWorker = currentSystem == this;
+    const uint32_t queueIndex = isWorker ? currentWorker : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    // Counted before it is queued, so whoever takes it never decrements below zero. Taking the lock orders
+    // this with a worker that just checked the counter and is about to sleep.
+    bool hasWaitingThreads = false;
+    {
+        std::scoped_lock lock(sleepMutex);
+        numQueuedJobs.fetch_add(1, std::memory_order_release);
+        hasWaitingThreads = numWaitingThreads != 0;
+    }
+
+    {
+        std::scoped_lock lock(queues[queueIndex]->mutex);
+        queues[queueIndex]->jobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+    if (hasWaitingThreads) {
+        waitProgress.notify_all();
+    }
+}
+
+bool JobSystem::TryPop(uint32_t queueIndex, Job& job) {
+    auto& queue = *queues[queueIndex];
+    std::scoped_lock lock(queue.mutex);
+    if (queue.jobs.empty()) {
+        return false;
+    }
+
+    // newest first, its data is most likely still in the cache
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::TrySteal(uint32_t thiefIndex, Job& job) {
+    for (uint32_t offset = 1; offset <= queues.size(); offset++) {
+        auto& queue = *queues[(thiefIndex + offset) % queues.size()];
+        std::scoped_lock lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            continue;
+        }
+
+        // oldest first, those tend to be the biggest pieces of work
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+JobSystem::Job JobSystem::Count(Job&& job, JobCounter& counter) {
+    // counted before it is queued, so waiting on the counter right after this can't miss it
+    counter.numPending.fetch_add(1, std::memory_order_relaxed);
+    return [this, &counter, job = std::move(job)]() {
+        // a job that threw still has to release its waiters and dependents
+        ScopeGuard finish([this, &counter]() { Finish(counter); });
+        job();
+    };
+}
+
+void JobSystem::Run(Job&& job, JobCounter* counter, JobCounter* dependency) {
+    if (counter != nullptr) {
+        job = Count(std::move(job), *counter);
+    }
+
+    if (dependency != nullptr) {
+        // Finish() takes the dependents under the same lock, so the job is either taken by it or queued here
+        std::scoped_lock lock(dependency->mutex);
+        if (!dependency->IsDone()) {
+            dependency->dependents.push_back(std::move(job));
+            return;
+        }
+    }
+
+    Push(std::move(job));
+}
+
+void JobSystem::RunLong(Job&& job, JobCounter* counter) {
+    if (counter != nullptr) {
+        job = Count(std::move(job), *counter);
+    }
+
+    {
+        std::scoped_lock lock(sleepMutex);
+        longJobs.push_back(std::move(job));
+    }
+    // waiting threads can't take it, so this has to reach a worker
+    jobAvailable.notify_all();
+}
+
+void JobSystem::Finish(JobCounter& counter) {
+    // The counter may be destroyed right after it is done, so it is only touched under the lock that Wait()
+    // takes before returning. The dependents are queued after letting go of it.
+    std::vector<Job> dependents;
+    bool isDone = false;
+    {
+        std::scoped_lock lock(counter.mutex);
+        isDone = counter.numPending.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        if (isDone) {
+            dependents = std::exchange(counter.dependents, {});
+        }
+    }
+    for (auto& dependent : dependents) {
+        Push(std::move(dependent));
+    }
+
+    // a thread in Wait() checks the counter under the same lock before sleeping, so it can't miss this
+    if (isDone) {
+        bool hasWaitingThreads = false;
+        {
+            std::scoped_lock lock(sleepMutex);
+            hasWaitingThreads = numWaitingThreads != 0;
+        }
+        if (hasWaitingThreads) {
+            waitProgress.notify_all();
+        }
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    while (!counter.IsDone()) {
+        if (TryRunJob()) {
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex);
+        numWaitingThreads++;
+        waitProgress.wait(lock, [this, &counter]() {
+            return counter.IsDone() || numQueuedJobs.load(std::memory_order_acquire) != 0;
+        });
+        numWaitingThreads--;
+    }
+
+    // the job that finished last might still hold the lock
+    std::scoped_lock lock(counter.mutex);
+}
+
+std::optional<uint32_t> JobSystem::GetCurrentWorkerIndex() const {
+    if (currentSystem != this) {
+        return std::nullopt;
+    }
+    return currentWorker;
+}
+
+bool JobSystem::TryRunJob() {
+    const uint32_t index = currentSystem == this ? currentWorker : 0;
+
+    Job job;
+    if (!TryPop(index, job) && !TrySteal(index, job)) {
+        return false;
+    }
+
+    numQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    Execute(job);
+    return true;
+}
+
+bool JobSystem::TryRunLongJob() {
+    Job job;
+    {
+        std::scoped_lock lock(sleepMutex);
+        if (longJobs.empty() || numRunningLongJobs >= maxRunningLongJobs) {
+            return false;
+        }
+        job = std::move(longJobs.front());
+        longJobs.pop_front();
+        numRunningLongJobs++;
+    }
+
+    Execute(job);
+
+    // other workers may have gone to sleep because too many were running, or be waiting for the last one to stop
+    {
+        std::scoped_lock lock(sleepMutex);
+        numRunningLongJobs--;
+    }
+    jobAvailable.notify_all();
+    return true;
+}
+
+void JobSystem::Execute(Job& job) {
+    // the worker has to keep going, an exception leaving it would terminate the whole program
+    try {
+        job();
+    }
+    catch (std::exception const& e) {
+        LUMINA_LOG_ERROR(General, "Job failed: {}", e.what());
+    }
+    catch (...) {
+        LUMINA_LOG_ERROR(General, "Job failed with an unknown exception");
+    }
+}
+
+void JobSystem::WorkerLoop(uint32_t index) {
+    currentSystem = this;
+    currentWorker = index;
+
+    while (true) {
+        // short jobs first, the frame might be waiting on them
+        if (TryRunJob() || TryRunLongJob()) {
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex);
+        // finish all queued jobs before stopping, someone might be waiting on them
+        auto isDrained = [this]() { return numQueuedJobs.load(std::memory_order_acquire) == 0 && longJobs.empty(); };
+        jobAvailable.wait(lock, [&]() {
+            return numQueuedJobs.load(std::memory_order_acquire) != 0
+                || (!longJobs.empty() && numRunningLongJobs < maxRunningLongJobs) || (isStopping && isDrained());
+        });
+
+        if (isStopping && isDrained()) {
+            return;
+        }
+    }
+}
+
+}
\ No newline at end of file
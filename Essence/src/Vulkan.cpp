@@ -32,12 +32,23 @@ vk::RenderingInfo CreateRenderingInfo(vk::Extent2D renderExtent, vk::RenderingAt
 }
 
 vk::ShaderModule LoadShaderModule(std::string const& filename, vk::Device device) {
+    // heap allocations are aligned for any fundamental type, so the bytes can be used as they are
     std::vector<uint8_t> bytes = ReadBinaryFile(filename);
-    std::vector<uint32_t> buffer(bytes.size() / sizeof(uint32_t));
-
-    std::memcpy(buffer.data(), bytes.data(), bytes.size());
-
-    return device.createShaderModule({{}, buffer});
+    return LoadShaderModule(bytes, device);
+}
+vk::ShaderModule LoadShaderModule(std::span<const uint8_t> code, vk::Device device) {
+    if (reinterpret_cast<uintptr_t>(code.data()) % alignof(uint32_t) != 0 || code.size() % sizeof(uint32_t) != 0) { // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) only looks at the address
+        throw std::runtime_error("SPIR-V code has to be 4 byte aligned!");
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast) checked above
+    auto const* words = reinterpret_cast<uint32_t const*>(code.data());
+    vk::ShaderModuleCreateInfo moduleInfo = {
+        {},          // flags
+        code.size(), // code size in bytes
+        words,       // code
+    };
+    return device.createShaderModule(moduleInfo);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Lumina/Essence/VulkanBuffer.hpp"
+#include "Lumina/Essence/Application.hpp"
+#include "Lumina/Essence/Log.hpp"
+
+
+namespace Lumina::Essence {
+
+VulkanBuffer::VulkanBuffer(Application& app, vk::DeviceSize size, vk::BufferUsageFlags usageFlags, VmaMemoryUsage memoryUsage, VmaAllocationCreateFlags allocationFlags) {
+    this->size = size;
+    this->app = &app;
+
+    vk::BufferCreateInfo bufferInfo = {
+        {},         // flags
+        size,       // size
+        usageFlags, // usage flags
+    };
+    VkBufferCreateInfo oldBufferInfo = bufferInfo;
+
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.usage = memoryUsage;
+    allocInfo.flags = allocationFlags;
+
+    allocation = {};
+    VmaAllocationInfo allocationResult = {};
+    VkBuffer oldBuffer = nullptr;
+    VkCheck(vk::Result(vmaCreateBuffer(app.allocator, &oldBufferInfo, &allocInfo, &oldBuffer, &allocation, &allocationResult)));
+    buffer = oldBuffer;
+
+    mappedData = allocationResult.pMappedData;
+
+    deviceAddress = 0;
+    if (usageFlags & vk::BufferUsageFlagBits::eShaderDeviceAddress) {
+        deviceAddress = app.device.getBufferAddress({buffer});
+    }
+
+    destroyed = false;
+}
+VulkanBuffer::VulkanBuffer() {
+    buffer = vk::Buffer{};
+    allocation = {};
+    size = 0;
+    mappedData = nullptr;
+    deviceAddress = 0;
+
+    app = nullptr;
+    destroyed = true;
+}
+
+VulkanBuffer::VulkanBuffer(VulkanBuffer&& other) noexcept { // NOLINT(cppcoreguidelines-pro-type-member-init) it does initialize everything
+    *this = std::move(other);
+}
+VulkanBuffer& VulkanBuffer::operator=(VulkanBuffer&& other) noexcept {
+    if (!destroyed) {
+        Destroy();
+    }
+
+    buffer = other.buffer;
+    other.buffer = vk::Buffer{};
+    allocation = other.allocation;
+    other.allocation = {};
+    size = other.size;
+    other.size = 0;
+    mappedData = other.mappedData;
+    other.mappedData = nullptr;
+    deviceAddress = other.deviceAddress;
+    other.deviceAddress = 0;
+
+    app = other.app;
+    other.app = nullptr;
+
+    destroyed = other.destroyed;
+    other.destroyed = true;
+
+    return *this;
+}
+
+
+VulkanBuffer::~VulkanBuffer() {
+    if (!destroyed) {
+        Destroy();
+    }
+}
+
+void VulkanBuffer::FlushMappedRange(vk::DeviceSize offset, vk::DeviceSize size) {
+    vmaFlushAllocation(app->allocator, allocation, offset, size);
+}
+
+void VulkanBuffer::InvalidateMappedRange(vk::DeviceSize offset, vk::DeviceSize size) {
+    vmaInvalidateAllocation(app->allocator, allocation, offset, size);
+}
+
+void VulkanBuffer::Destroy() {
+    if (destroyed) {
+        LUMINA_LOG_ERROR(Resources, "Tried destroying buffer twice");
+        return;
+    }
+
+    vmaDestroyBuffer(app->allocator, buffer, allocation); // also unmaps persistently mapped memory
+
+    app = nullptr;
+    destroyed = true;
+}
+void VulkanBuffer::Retire(RetirementQueue& queue, uint64_t retireValue, char const* name) {
+    if (destroyed) {
+        LUMINA_LOG_ERROR(Resources, "Tried retiring a destroyed buffer");
+        return;
+    }
+
+    queue.Retire(buffer, allocation, retireValue, name);
+    mappedData = nullptr;
+
+    app = nullptr;
+    destroyed = true;
+}
+
+}
\ No newline at end of file
@@ -1,22 +1,29 @@
 #include "Lumina/Essence/VulkanImage.hpp"
 #include "Lumina/Essence/Application.hpp"
+#include "Lumina/Essence/Log.hpp"
 
-#include <iostream>
+#include <algorithm>
 
 namespace Lumina::Essence {
 
-VulkanImage::VulkanImage(Application& app, vk::Format format, vk::ImageUsageFlags usageFlags, vk::Extent3D extent, vk::ImageAspectFlags aspectFlags) {
+VulkanImage::VulkanImage(Application& app, vk::Format format, vk::ImageUsageFlags usageFlags, vk::Extent3D extent, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels, uint32_t arrayLayers) {
     this->imageFormat = format;
     this->imageExtent = extent;
+    this->aspectFlags = aspectFlags;
+    this->mipLevels = mipLevels;
+    this->arrayLayers = arrayLayers;
     this->app = &app;
 
+    // a new image has no contents and no pending accesses
+    subresourceStates.assign(mipLevels * arrayLayers, SyncState{});
+
     vk::ImageCreateInfo imageInfo = {
         {},                          // flags
         vk::ImageType::e2D,          // image tpe
         format,                      // format
         extent,                      // size
-        1,                           // mip levels
-        1,                           // array layers
+        mipLevels,                   // mip levels
+        arrayLayers,                 // array layers
         vk::SampleCountFlagBits::e1, // num samples
         vk::ImageTiling::eOptimal,   // image tiling
         usageFlags,                  // usage flags
@@ -35,7 +42,7 @@ VulkanImage::VulkanImage(Application& app, vk::Format format, vk::ImageUsageFlag
     vk::ImageViewCreateInfo viewInfo = {
         {},                                              // flags
         image,                                           // image
-        vk::ImageViewType::e2D,                          // view type
+        arrayLayers > 1 ? vk::ImageViewType::e2DArray : vk::ImageViewType::e2D, // view type
         format,                                          // image format
         {},                                              // component mapping
         CreateSubresourceRangeForAllLayers(aspectFlags), // subresource range
@@ -50,6 +57,7 @@ VulkanImage::VulkanImage() {
     imageView = vk::ImageView{};
     imageExtent = vk::Extent3D{};
     imageFormat = {};
+    aspectFlags = {};
     allocation = {};
 
     app = nullptr;
@@ -72,6 +80,14 @@ VulkanImage& VulkanImage::operator=(VulkanImage&& other) noexcept {
     other.imageExtent = vk::Extent3D{};
     imageFormat = other.imageFormat;
     other.imageFormat = {};
+    aspectFlags = other.aspectFlags;
+    other.aspectFlags = {};
+    mipLevels = other.mipLevels;
+    other.mipLevels = 1;
+    arrayLayers = other.arrayLayers;
+    other.arrayLayers = 1;
+    subresourceStates = std::move(other.subresourceStates);
+    other.subresourceStates.clear();
     allocation = other.allocation;
     other.allocation = {};
 
@@ -93,7 +109,7 @@ VulkanImage::~VulkanImage() {
 
 void VulkanImage::Destroy() {
     if (destroyed) {
-        std::cerr << "[Vulkan][Error] Tried destroying image twice\n";
+        LUMINA_LOG_ERROR(Resources, "Tried destroying image twice");
         return;
     }
 
@@ -103,6 +119,18 @@ void VulkanImage::Destroy() {
     app = nullptr;
     destroyed = true;
 }
+void VulkanImage::Retire(RetirementQueue& queue, uint64_t retireValue, char const* name) {
+    if (destroyed) {
+        LUMINA_LOG_ERROR(Resources, "Tried retiring a destroyed image");
+        return;
+    }
+
+    queue.Retire(imageView, retireValue, name);
+    queue.Retire(image, allocation, retireValue, name);
+
+    app = nullptr;
+    destroyed = true;
+}
 
 
 void VulkanImage::Blit(vk::CommandBuffer cmd, vk::Image source, vk::Image target, vk::Extent2D sourceSize, vk::Extent2D targetSize) {
@@ -153,34 +181,90 @@ void VulkanImage::Blit(vk::CommandBuffer cmd, vk::Image source, vk::Image target
 }
 
 
-void VulkanImage::Transition(vk::CommandBuffer cmd, vk::Image img, vk::ImageLayout srcLayout, vk::ImageLayout dstLayout) {
-    vk::ImageAspectFlags aspectMask = (dstLayout == vk::ImageLayout::eDepthAttachmentOptimal)
-                                        ? vk::ImageAspectFlagBits::eDepth
-                                        : vk::ImageAspectFlagBits::eColor;
+void VulkanImage::TransitionTo(vk::CommandBuffer cmd, vk::ImageLayout layout, vk::PipelineStageFlags2 stage, vk::AccessFlags2 access) {
+    TransitionTo(cmd, layout, stage, access, CreateSubresourceRangeForAllLayers(aspectFlags));
+}
+void VulkanImage::TransitionTo(vk::CommandBuffer cmd, vk::ImageLayout layout, vk::PipelineStageFlags2 stage, vk::AccessFlags2 access, vk::ImageSubresourceRange const& range) {
+    TransitionBatch batch;
+    TransitionTo(batch, layout, stage, access, range);
+    batch.Record(cmd);
+}
+void VulkanImage::TransitionTo(TransitionBatch& batch, vk::ImageLayout layout, vk::PipelineStageFlags2 stage, vk::AccessFlags2 access, vk::ImageSubresourceRange const& range) {
+    const uint32_t levelCount = range.levelCount == vk::RemainingMipLevels ? mipLevels - range.baseMipLevel : range.levelCount;
+    const uint32_t layerCount = range.layerCount == vk::RemainingArrayLayers ? arrayLayers - range.baseArrayLayer : range.layerCount;
+    const bool isWrite = IsWriteAccess(access);
 
-    // clang-format off
-    vk::ImageMemoryBarrier2 imageBarrier = {
-        vk::PipelineStageFlagBits2::eAllCommands,                             // source stage mask
-        vk::AccessFlagBits2::eMemoryWrite,                                    // source access mask
-        vk::PipelineStageFlagBits2::eAllCommands,                             // destination stage mask
-        vk::AccessFlagBits2::eMemoryWrite | vk::AccessFlagBits2::eMemoryRead, // destination access mask
-        srcLayout,                                                            // current layout
-        dstLayout,                                                            // new layout
-        0,                                                                    // source queue family index
-        0,                                                                    // dest queue family index
-        img,
-        CreateSubresourceRangeForAllLayers(aspectMask)
+    auto getState = [&](uint32_t mip, uint32_t layer) -> SyncState& {
+        return subresourceStates.at((range.baseArrayLayer + layer) * mipLevels + range.baseMipLevel + mip);
     };
-    // clang-format on
+
+    auto addBarrier = [&](Dependency const& dependency, vk::ImageSubresourceRange const& barrierRange) {
+        batch.barriers.push_back({
+            dependency.srcStage,    // source stage mask
+            dependency.srcAccess,   // source access mask
+            stage,                  // destination stage mask
+            access,                 // destination access mask
+            dependency.oldLayout,   // current layout
+            layout,                 // new layout
+            vk::QueueFamilyIgnored, // source queue family index
+            vk::QueueFamilyIgnored, // dest queue family index
+            image,
+            barrierRange,
+        });
+    };
+
+    // the common case: the whole range is in the same state and needs only one barrier
+    const SyncState& first = getState(0, 0);
+    bool isUniform = true;
+    for (uint32_t layer = 0; layer < layerCount && isUniform; layer++) {
+        for (uint32_t mip = 0; mip < levelCount && isUniform; mip++) {
+            isUniform = getState(mip, layer) == first;
+        }
+    }
+
+    if (isUniform) {
+        SyncState state = first;
+        auto dependency = state.Access(stage, access, layout, isWrite);
+        for (uint32_t layer = 0; layer < layerCount; layer++) {
+            for (uint32_t mip = 0; mip < levelCount; mip++) {
+                getState(mip, layer) = state;
+            }
+        }
+        if (dependency) {
+            addBarrier(*dependency, {range.aspectMask, range.baseMipLevel, levelCount, range.baseArrayLayer, layerCount});
+        }
+        return;
+    }
+
+    for (uint32_t layer = 0; layer < layerCount; layer++) {
+        for (uint32_t mip = 0; mip < levelCount; mip++) {
+            auto dependency = getState(mip, layer).Access(stage, access, layout, isWrite);
+            if (dependency) {
+                addBarrier(*dependency, {range.aspectMask, range.baseMipLevel + mip, 1, range.baseArrayLayer + layer, 1});
+            }
+        }
+    }
+}
+
+void VulkanImage::SetState(SyncState const& state) {
+    std::ranges::fill(subresourceStates, state);
+}
+
+
+void VulkanImage::TransitionBatch::Record(vk::CommandBuffer cmd) {
+    if (barriers.empty()) {
+        return;
+    }
 
     vk::DependencyInfo dependencyInfo = {
-        {},           // flags
-        nullptr,      // memory barriers
-        nullptr,      // buffer barriers
-        imageBarrier, // image barriers
+        {},       // flags
+        nullptr,  // memory barriers
+        nullptr,  // buffer barriers
+        barriers, // image barriers
     };
 
     cmd.pipelineBarrier2(dependencyInfo);
+    barriers.clear();
 }
 
 }
\ No newline at end of file
@@ -7,7 +7,7 @@ namespace Lumina::Essence {
 Window::Window(glm::ivec2 size, std::string const& title) {
     SDL_Init(SDL_INIT_VIDEO);
 
-    window = SDL_CreateWindow(title.c_str(), size.x, size.y, SDL_WINDOW_VULKAN);
+    window = SDL_CreateWindow(title.c_str(), size.x, size.y, SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
     SDL_StartTextInput(window);
 }
 
@@ -21,6 +21,17 @@ std::optional<SDL_Event> Window::GetEvent() {
     return SDL_PollEvent(&e) != 0 ? e : std::optional<SDL_Event>{};
 }
 
+glm::ivec2 Window::GetPixelSize() const {
+    glm::ivec2 size = {};
+    SDL_GetWindowSizeInPixels(window, &size.x, &size.y);
+    return size;
+}
+glm::ivec2 Window::GetSize() const {
+    glm::ivec2 size = {};
+    SDL_GetWindowSize(window, &size.x, &size.y);
+    return size;
+}
+
 
 vk::SurfaceKHR Window::CreateWindowSurface(vk::Instance instance) const {
     VkSurfaceKHR surface = nullptr;
@@ -0,0 +1,175 @@
+#include "Lumina/Essence/WorkgroupTuner.hpp"
+#include "Lumina/Essence/Utils/FileIO.hpp"
+#include "Lumina/Essence/Log.hpp"
+
+#include <array>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace Lumina::Essence {
+
+void WorkgroupTuner::Initialize(vk::PhysicalDevice physicalDevice, vk::Device device, uint32_t queueFamily, std::string const& path) {
+    this->device = device;
+    this->path = path;
+
+    auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>();
+    limits = properties.get<vk::PhysicalDeviceProperties2>().properties.limits;
+    timestampPeriod = limits.timestampPeriod;
+
+    deviceId.clear();
+    for (uint8_t byte : properties.get<vk::PhysicalDeviceIDProperties>().deviceUUID) {
+        deviceId += std::format("{:02x}", byte);
+    }
+
+    auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+    isTimestampSupported = queueFamilies.at(queueFamily).timestampValidBits != 0 && timestampPeriod > 0;
+    if (isTimestampSupported) {
+        vk::QueryPoolCreateInfo poolInfo = {
+            {},                        // flags
+            vk::QueryType::eTimestamp, // query type
+            2,                         // num queries
+        };
+        queryPool = device.createQueryPool(poolInfo);
+    }
+
+    Load();
+}
+void WorkgroupTuner::Destroy() {
+    if (queryPool) {
+        device.destroyQueryPool(queryPool);
+        queryPool = nullptr;
+    }
+}
+
+
+std::optional<WorkgroupTuner::Shape> WorkgroupTuner::GetStoredShape(std::string const& kernel) const {
+    auto it = shapes.find(GetKey(kernel));
+    if (it == shapes.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::vector<WorkgroupTuner::Shape> WorkgroupTuner::GetCandidates() const {
+    constexpr std::array<Shape, 10> shapes = {{
+        {8, 8},
+        {16, 8},
+        {8, 16},
+        {16, 16},
+        {32, 4},
+        {32, 8},
+        {8, 32},
+        {64, 2},
+        {64, 4},
+        {32, 32},
+    }};
+
+    std::vector<Shape> candidates;
+    for (auto shape : shapes) {
+        if (shape.x <= limits.maxComputeWorkGroupSize[0]
+            && shape.y <= limits.maxComputeWorkGroupSize[1]
+            && shape.x * shape.y <= limits.maxComputeWorkGroupInvocations) {
+            candidates.push_back(shape);
+        }
+    }
+    return candidates;
+}
+
+WorkgroupTuner::Shape WorkgroupTuner::Tune(std::string const& kernel, SubmitFunction const& submit, DispatchFunction const& dispatch) {
+    if (!isTimestampSupported) {
+        LUMINA_LOG_WARNING(Profiling, "Can't tune \"{}\" without GPU timestamps, using the default workgroup shape", kernel);
+        return {};
+    }
+
+    Shape bestShape;
+    double bestTime = std::numeric_limits<double>::max();
+
+    for (Shape shape : GetCandidates()) {
+        submit([&](vk::CommandBuffer cmd) {
+            cmd.resetQueryPool(queryPool, 0, 2);
+
+            // the first dispatch warms up caches and clocks and isn't timed
+            dispatch(cmd, shape);
+
+            // consecutive dispatches write the same image, keep them from overlapping
+            vk::MemoryBarrier2 barrier = {
+                vk::PipelineStageFlagBits2::eComputeShader,                                         // source stage mask
+                vk::AccessFlagBits2::eShaderStorageWrite,                                           // source access mask
+                vk::PipelineStageFlagBits2::eComputeShader,                                         // destination stage mask
+                vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite, // destination access mask
+            };
+            cmd.pipelineBarrier2({{}, barrier});
+
+            cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, queryPool, 0);
+            for (uint32_t i = 0; i < numTimedDispatches; i++) {
+                dispatch(cmd, shape);
+                cmd.pipelineBarrier2({{}, barrier});
+            }
+            cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, queryPool, 1);
+        });
+
+        std::array<uint64_t, 2> timestamps = {};
+        vk::Result res = device.getQueryPoolResults(
+            queryPool,
+            0,
+            2,
+            sizeof(timestamps),
+            timestamps.data(),
+            sizeof(uint64_t),
+            vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait
+        );
+        if (res != vk::Result::eSuccess) {
+            continue;
+        }
+
+        double timeMs = static_cast<double>(timestamps[1] - timestamps[0]) * timestampPeriod / 1e6 / numTimedDispatches;
+        LUMINA_LOG_DEBUG(Profiling, "  {}x{}: {:.3f}ms", shape.x, shape.y, timeMs);
+        if (timeMs < bestTime) {
+            bestTime = timeMs;
+            bestShape = shape;
+        }
+    }
+
+    LUMINA_LOG_INFO(Profiling, "Best workgroup shape for \"{}\" is {}x{}", kernel, bestShape.x, bestShape.y);
+    shapes[GetKey(kernel)] = bestShape;
+    return bestShape;
+}
+
+
+std::string WorkgroupTuner::GetKey(std::string const& kernel) const {
+    return deviceId + " " + kernel;
+}
+
+void WorkgroupTuner::Load() {
+    shapes.clear();
+    if (!std::filesystem::exists(path)) {
+        return;
+    }
+
+    // one "<device UUID> <kernel> <x> <y>" per line, kernel names don't contain spaces
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string device;
+        std::string kernel;
+        Shape shape;
+        if (stream >> device >> kernel >> shape.x >> shape.y && shape.x > 0 && shape.y > 0) {
+            shapes[device + " " + kernel] = shape;
+        }
+    }
+}
+
+void WorkgroupTuner::Save() const {
+    std::string contents;
+    for (auto const& [key, shape] : shapes) {
+        contents += std::format("{} {} {}\n", key, shape.x, shape.y);
+    }
+
+    WriteBinaryFileAtomically(path, std::span(reinterpret_cast<const uint8_t*>(contents.data()), contents.size())); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast) bytes of a string
+}
+
+}
\ No newline at end of file
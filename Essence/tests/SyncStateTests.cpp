@@ -0,0 +1,84 @@
+#include "Lumina/Essence/SyncState.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace Lumina::Essence;
+
+namespace {
+
+int numFailures = 0;
+
+void Check(bool condition, char const* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        numFailures++;
+    }
+}
+
+constexpr auto compute = vk::PipelineStageFlagBits2::eComputeShader;
+constexpr auto storageRead = vk::AccessFlagBits2::eShaderStorageRead;
+constexpr auto storageWrite = vk::AccessFlagBits2::eShaderStorageWrite;
+constexpr auto general = vk::ImageLayout::eGeneral;
+
+// like the gradient pass writing the accumulation image and the resolve pass reading it
+void WriteThenReadAtSameStage() {
+    SyncState state = SyncState::FromLastAccess(compute, vk::AccessFlagBits2::eNone, general);
+    state.Access(compute, storageRead | storageWrite, general, true);
+
+    auto read = state.Access(compute, storageRead, general, false);
+    Check(read.has_value(), "a read after a write at the same stage needs a barrier");
+    Check(read.has_value() && read->srcStage == compute, "the read waits for the writing stage");
+    Check(read.has_value() && read->srcAccess == storageWrite, "only the write bits are made available");
+
+    auto secondRead = state.Access(compute, storageRead, general, false);
+    Check(!secondRead.has_value(), "a second read of the same kind is already visible");
+}
+
+void WriteThenWrite() {
+    SyncState state = SyncState::FromLastAccess(compute, vk::AccessFlagBits2::eNone, general);
+    state.Access(compute, storageWrite, general, true);
+
+    auto write = state.Access(compute, storageWrite, general, true);
+    Check(write.has_value(), "a write after a write needs a barrier");
+    Check(write.has_value() && write->srcAccess == storageWrite, "the second write waits for the first one");
+}
+
+void LayoutChange() {
+    SyncState state = SyncState::FromLastAccess(compute, vk::AccessFlagBits2::eNone, general);
+    state.Access(compute, storageWrite, general, true);
+
+    auto transfer = state.Access(
+        vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead, vk::ImageLayout::eTransferSrcOptimal, false
+    );
+    Check(transfer.has_value(), "a layout change always needs a barrier");
+    Check(transfer.has_value() && transfer->oldLayout == general, "the barrier starts from the old layout");
+    Check(state.layout == vk::ImageLayout::eTransferSrcOptimal, "the new layout is tracked");
+
+    auto read = state.Access(compute, storageRead, vk::ImageLayout::eTransferSrcOptimal, false);
+    Check(read.has_value(), "the transition isn't visible to other stages yet");
+}
+
+// the tuning submissions start from such a state and TransitionTo() the images from there
+void ImportedWrite() {
+    SyncState state = SyncState::FromLastAccess(compute, storageRead | storageWrite, general);
+    Check(state.writeAccess == storageWrite, "only the write bits of the last access are kept");
+
+    auto read = state.Access(compute, storageRead, general, false);
+    Check(read.has_value(), "the imported write isn't visible to anyone yet");
+}
+
+}
+
+int main() {
+    WriteThenReadAtSameStage();
+    WriteThenWrite();
+    LayoutChange();
+    ImportedWrite();
+
+    if (numFailures != 0) {
+        return EXIT_FAILURE;
+    }
+    std::printf("All SyncState tests passed\n");
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include "BenchApplication.hpp"
+
+#include "Lumina/Essence/Log.hpp"
+
+#include <array>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace Lumina::Bench {
+
+namespace {
+
+constexpr auto gradientShaderPath = "resources/shaders/gradient.comp.spv";
+
+double ToMs(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}
+
+std::optional<Scenario> ParseScenario(std::string_view name) {
+    for (Scenario scenario :
+         {Scenario::Julia,
+          Scenario::JuliaBatched,
+          Scenario::Triangle,
+          Scenario::Full,
+          Scenario::Pipelines,
+          Scenario::Uploads,
+          Scenario::Cpu}) {
+        if (name == ToString(scenario)) {
+            return scenario;
+        }
+    }
+    return std::nullopt;
+}
+
+char const* ToString(Scenario scenario) {
+    switch (scenario) {
+    case Scenario::Julia:
+        return "julia";
+    case Scenario::JuliaBatched:
+        return "julia-batched";
+    case Scenario::Triangle:
+        return "triangle";
+    case Scenario::Full:
+        return "full";
+    case Scenario::Pipelines:
+        return "pipelines";
+    case Scenario::Uploads:
+        return "uploads";
+    case Scenario::Cpu:
+        return "cpu";
+    }
+    return "unknown";
+}
+
+BenchApplication::BenchApplication(Scenario scenario, BenchSettings const& settings)
+    : Application({1280, 720}, std::format("Lumina Bench ({})", ToString(scenario)), settings.displayMode),
+      scenario(scenario),
+      settings(settings) {
+    // the cpu scenario renders on the GPU too, to have something to compare against
+    isJuliaEnabled = scenario == Scenario::Julia || scenario == Scenario::JuliaBatched || scenario == Scenario::Full
+                  || scenario == Scenario::Cpu;
+    isTriangleEnabled = scenario == Scenario::Triangle || scenario == Scenario::Full;
+    isImGuiEnabled = scenario == Scenario::Full;
+    if (scenario == Scenario::JuliaBatched) {
+        // one batch more than there are workers, so the frame thread records one too
+        numJuliaBatches = jobSystem.GetThreadCount() + 1;
+    }
+    if (scenario == Scenario::Cpu) {
+        // the same fractal every frame, so any frame can be read back. A connected set like the one the
+        // tuner uses, c on the circle at time 0 gives dust that escapes almost everywhere.
+        isJuliaAnimated = false;
+        pinnedJuliaParameter = glm::dvec2(-0.8, 0.156);
+    }
+
+    // every frame has to do the same work, and nothing may depend on earlier runs
+    isShaderHotReloadEnabled = false;
+    isWorkgroupTuningEnabled = false;
+    progressiveAccumulation.settings.enabled = false;
+    dynamicResolution.settings.enabled = false;
+}
+
+BenchApplication::~BenchApplication() {
+    // earlier frames may still copy into it, the base class waits for them before destroying retired resources
+    if (scenario == Scenario::Uploads) {
+        uploadTarget.Retire(retirementQueue, GetFrameTimelineValue(), "upload target");
+    }
+    if (scenario == Scenario::Cpu) {
+        readbackBuffer.Retire(retirementQueue, GetFrameTimelineValue(), "readback buffer");
+    }
+}
+
+void BenchApplication::Initialize() {
+    Application::Initialize();
+
+    if (scenario == Scenario::Uploads) {
+        uploadTarget = Essence::VulkanBuffer(
+            *this,
+            uploadBytesPerFrame,
+            vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eStorageBuffer,
+            VMA_MEMORY_USAGE_AUTO
+        );
+        uploadData.resize(uploadBytesPerFrame);
+        for (size_t i = 0; i < uploadData.size(); i++) {
+            uploadData[i] = static_cast<std::byte>(i * 31);
+        }
+    }
+
+    if (scenario == Scenario::Cpu) {
+        // big enough for any draw extent, the draw image only grows beyond the window with dynamic resolution
+        const vk::Extent3D drawImageExtent = drawImage.GetExtent();
+        readbackBuffer = Essence::VulkanBuffer(
+            *this,
+            vk::DeviceSize(drawImageExtent.width) * drawImageExtent.height * 4 * sizeof(uint16_t),
+            vk::BufferUsageFlagBits::eTransferDst,
+            VMA_MEMORY_USAGE_AUTO,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+        );
+
+        constexpr std::array<char const*, 3> instructionSetNames = {"scalar", "SSE2", "AVX2"};
+        LUMINA_LOG_INFO(
+            General,
+            "Rendering on the CPU with {}",
+            instructionSetNames.at(static_cast<size_t>(cpuRenderer.GetInstructionSet()))
+        );
+    }
+
+    LUMINA_LOG_INFO(General, "Running scenario \"{}\" with {} warmup frames", ToString(scenario), settings.numWarmupFrames);
+}
+
+bool BenchApplication::IsMeasuring() const {
+    return numRenderedFrames >= settings.numWarmupFrames;
+}
+
+void BenchApplication::PreRender(float dt) {
+    if (numRenderedFrames == settings.numWarmupFrames) {
+        measureStart = std::chrono::steady_clock::now();
+    }
+    frameStart = std::chrono::steady_clock::now();
+
+    Application::PreRender(dt);
+
+    if (scenario != Scenario::Uploads) {
+        return;
+    }
+
+    // before Render(), which makes the copies visible to the rest of the frame
+    vk::CommandBuffer cmd = GetCurrentCommandBuffer();
+    auto zone = gpuProfiler.Scope(cmd, "upload");
+
+    auto uploadStart = std::chrono::steady_clock::now();
+    if (!stagingRing.Upload(cmd, uploadTarget, 0, uploadData)) {
+        throw std::runtime_error("The staging ring is too small for the upload scenario");
+    }
+    if (IsMeasuring()) {
+        stepMs.push_back(ToMs(std::chrono::steady_clock::now() - uploadStart));
+    }
+}
+
+void BenchApplication::Render(float dt) {
+    Application::Render(dt);
+
+    if (scenario == Scenario::Cpu) {
+        RenderOnCpu();
+        return;
+    }
+    if (scenario != Scenario::Pipelines) {
+        return;
+    }
+
+    // cycles through the tuner's workgroup shapes, so after the first round the pipeline cache is warm like on a real run
+    auto candidates = workgroupTuner.GetCandidates();
+    auto shape = candidates.at(numCompiledPipelines++ % candidates.size());
+    std::vector<Essence::SpecializationConstant> constants = {
+        {0, shape.x},
+        {1, shape.y},
+    };
+
+    auto compileStart = std::chrono::steady_clock::now();
+    Essence::PipelineHandle pipeline = pipelineCompiler.CompileCompute(gradientShaderPath, bindlessHeap.GetPipelineLayout(), constants);
+    pipeline.Get();
+    if (IsMeasuring()) {
+        stepMs.push_back(ToMs(std::chrono::steady_clock::now() - compileStart));
+    }
+
+    // never recorded, so it can go right away
+    pipeline.Destroy(device);
+}
+
+void BenchApplication::RenderOnCpu() {
+    // the same view the Julia pass of this frame renders, after Application::Render() advanced it
+    const glm::vec2 renderSize = glm::vec2(drawExtent.width, drawExtent.height);
+    Essence::CpuFractalRenderer::Parameters parameters = {
+        {drawExtent.width, drawExtent.height},
+        deepZoom.GetCenter(),
+        deepZoom.GetPixelScale(renderSize),
+        deepZoom.GetJuliaParameter(),
+        deepZoom.GetMaxIterations(),
+        progressiveAccumulation.settings.fullRenderSamples,
+        juliaColor,
+    };
+
+    auto renderStart = std::chrono::steady_clock::now();
+    cpuRenderer.Render(parameters, jobSystem);
+    if (IsMeasuring()) {
+        stepMs.push_back(ToMs(std::chrono::steady_clock::now() - renderStart));
+    }
+
+    // the first measured frame is read back, by then the pipelines are compiled for sure
+    if (numRenderedFrames != settings.numWarmupFrames) {
+        return;
+    }
+    auto pixels = cpuRenderer.GetPixels();
+    referencePixels.assign(pixels.begin(), pixels.end());
+    readbackValue = GetFrameTimelineValue();
+
+    renderGraph.AddPass("readback")
+        .Read(
+            drawImageResource,
+            {vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferRead, vk::ImageLayout::eTransferSrcOptimal}
+        )
+        .SetSideEffects()
+        .SetExecute([this, extent = drawExtent](vk::CommandBuffer cmd) {
+            // clang-format off
+            vk::BufferImageCopy2 region = {
+                0, // buffer offset
+                0, // buffer row length, 0 means tightly packed
+                0, // buffer image height, 0 means tightly packed
+                vk::ImageSubresourceLayers{
+                    vk::ImageAspectFlagBits::eColor, // aspect mask
+                    0,                               // mip level
+                    0,                               // base array layer
+                    1,                               // num array layers
+                },
+                vk::Offset3D{},                               // image offset
+                vk::Extent3D{extent.width, extent.height, 1}, // image extent
+            };
+            // clang-format on
+            cmd.copyImageToBuffer2({drawImage, vk::ImageLayout::eTransferSrcOptimal, readbackBuffer, region});
+
+            vk::MemoryBarrier2 toHost = {
+                vk::PipelineStageFlagBits2::eCopy,   // source stage mask
+                vk::AccessFlagBits2::eTransferWrite, // source access mask
+                vk::PipelineStageFlagBits2::eHost,   // destination stage mask
+                vk::AccessFlagBits2::eHostRead,      // destination access mask
+            };
+            cmd.pipelineBarrier2({{}, toHost});
+        });
+}
+
+void BenchApplication::CompareReadback() {
+    const size_t numHalfs = referencePixels.size();
+    readbackBuffer.InvalidateMappedRange(0, numHalfs * sizeof(uint16_t));
+    std::span<const uint16_t> gpuPixels(static_cast<uint16_t const*>(readbackBuffer.GetMappedData()), numHalfs);
+
+    gpuDifference = Essence::CpuFractalRenderer::Compare(gpuPixels, referencePixels, cpuTolerance);
+    readbackValue = 0;
+
+    const double mismatchPercent = 100.0 * gpuDifference->numMismatches / static_cast<double>(numHalfs / 4);
+    if (mismatchPercent > 1) {
+        LUMINA_LOG_WARNING(
+            General,
+            "GPU and CPU images differ in {:.2f}% of the pixels, max error {:.3f}",
+            mismatchPercent,
+            gpuDifference->maxError
+        );
+    }
+    else {
+        LUMINA_LOG_INFO(General, "GPU and CPU images match in all but {} pixels", gpuDifference->numMismatches);
+    }
+}
+
+void BenchApplication::PostRender(float dt) {
+    Application::PostRender(dt);
+
+    if (readbackValue != 0 && GetCompletedFrameValue() >= readbackValue) {
+        CompareReadback();
+    }
+
+    auto frameEnd = std::chrono::steady_clock::now();
+    if (IsMeasuring()) {
+        cpuFrameMs.push_back(ToMs(frameEnd - frameStart));
+        // lags behind by the number of frames in flight, which doesn't matter for the distribution
+        if (gpuProfiler.GetLastFrameTime() > 0) {
+            gpuFrameMs.push_back(gpuProfiler.GetLastFrameTime());
+        }
+    }
+    numRenderedFrames++;
+
+    auto numMeasuredFrames = static_cast<uint32_t>(cpuFrameMs.size());
+    bool isOutOfTime = settings.maxSeconds > 0 && IsMeasuring()
+                    && std::chrono::duration<double>(frameEnd - measureStart).count() >= settings.maxSeconds;
+    if (numMeasuredFrames >= settings.numFrames || isOutOfTime) {
+        measureEnd = frameEnd;
+        Exit();
+
+        // a short run may end before the GPU got to the readback
+        if (readbackValue != 0) {
+            device.waitIdle();
+            CompareReadback();
+        }
+    }
+}
+
+ScenarioResult BenchApplication::GetResult() const {
+    ScenarioResult result;
+    result.name = ToString(scenario);
+    result.numFrames = static_cast<uint32_t>(cpuFrameMs.size());
+    result.durationSeconds = std::chrono::duration<double>(measureEnd - measureStart).count();
+
+    result.distributions.emplace_back("cpu_frame_ms", Distribution::FromSamples(cpuFrameMs));
+    if (!gpuFrameMs.empty()) {
+        result.distributions.emplace_back("gpu_frame_ms", Distribution::FromSamples(gpuFrameMs));
+    }
+    if (scenario == Scenario::Pipelines) {
+        result.distributions.emplace_back("compile_ms", Distribution::FromSamples(stepMs));
+    }
+    else if (scenario == Scenario::Cpu) {
+        Distribution renderMs = Distribution::FromSamples(stepMs);
+        result.distributions.emplace_back("render_ms", renderMs);
+        if (renderMs.avg > 0) {
+            double numMegapixels = static_cast<double>(cpuRenderer.GetSize().x) * cpuRenderer.GetSize().y / 1e6;
+            result.values.emplace_back("megapixels_per_s", numMegapixels / (renderMs.avg / 1000.0));
+        }
+        if (gpuDifference.has_value()) {
+            double numPixels = static_cast<double>(referencePixels.size() / 4);
+            result.values.emplace_back("gpu_mismatch_percent", 100.0 * gpuDifference->numMismatches / numPixels);
+        }
+    }
+    else if (scenario == Scenario::Uploads) {
+        Distribution uploadMs = Distribution::FromSamples(stepMs);
+        result.distributions.emplace_back("upload_ms", uploadMs);
+        if (result.durationSeconds > 0) {
+            double totalMb = static_cast<double>(uploadBytesPerFrame) * result.numFrames / (1024.0 * 1024.0);
+            result.values.emplace_back("upload_mib_per_s", totalMb / result.durationSeconds);
+        }
+    }
+
+    for (auto const& phase : startupPhases) {
+        result.startupMs.emplace_back(phase.name, phase.durationMs);
+    }
+
+    result.values.emplace_back("peak_rss_mib", GetPeakRssMib());
+    result.values.emplace_back("gpu_memory_mib", GetGpuMemoryMib());
+    return result;
+}
+
+double BenchApplication::GetGpuMemoryMib() const {
+    VkPhysicalDeviceMemoryProperties const* memoryProperties = nullptr;
+    vmaGetMemoryProperties(allocator, &memoryProperties);
+
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets = {};
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    // only what this process allocated through vma, the driver's own allocations aren't part of it
+    VkDeviceSize usage = 0;
+    for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; i++) {
+        usage += budgets[i].statistics.blockBytes;
+    }
+    return static_cast<double>(usage) / (1024.0 * 1024.0);
+}
+
+double BenchApplication::GetPeakRssMib() {
+    // VmHWM is the high water mark of the resident set in kB, linux only
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("VmHWM:")) {
+            return std::stod(line.substr(6)) / 1024.0;
+        }
+    }
+    return 0;
+}
+
+}
\ No newline at end of file
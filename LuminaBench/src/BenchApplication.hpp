@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Report.hpp"
+
+#include "Lumina/Essence/Application.hpp"
+#include "Lumina/Essence/CpuFractalRenderer.hpp"
+
+#include <chrono>
+#include <optional>
+#include <string_view>
+
+namespace Lumina::Bench {
+
+enum class Scenario {
+    Julia,        // only the julia compute and resolve passes
+    JuliaBatched, // the same with the dispatch recorded in parallel batches
+    Triangle,     // only the triangle draw
+    Full,         // the default frame including imgui
+    Pipelines,    // a compute pipeline compiled every frame, nothing rendered
+    Uploads,      // a buffer uploaded through the staging ring every frame, nothing rendered
+    Cpu,          // the julia set rendered on the CPU every frame, checked against a GPU readback once
+};
+
+std::optional<Scenario> ParseScenario(std::string_view name);
+char const* ToString(Scenario scenario);
+
+struct BenchSettings {
+    uint32_t numFrames = 300;
+    double maxSeconds = 0;         // ends the measurement early if not 0
+    uint32_t numWarmupFrames = 30; // rendered before measuring, e.g. until all pipelines finished compiling
+    Essence::DisplayMode displayMode = Essence::DisplayMode::Headless;
+};
+
+// Drives the default frame of an Application with parts of it switched off and records how long its frames take.
+class BenchApplication : public Essence::Application {
+public:
+    BenchApplication(Scenario scenario, BenchSettings const& settings);
+    ~BenchApplication() override;
+
+    void Initialize() override;
+
+    void PreRender(float dt) override;
+    void Render(float dt) override;
+    void PostRender(float dt) override;
+
+    ScenarioResult GetResult() const;
+
+    static constexpr vk::DeviceSize uploadBytesPerFrame = 8 * 1024 * 1024;
+    // the CPU iterates every pixel directly instead of perturbing it, so pixels close to the boundary can
+    // escape at a different iteration
+    static constexpr float cpuTolerance = 0.05f;
+
+private:
+    bool IsMeasuring() const;
+    void RenderOnCpu();
+    void CompareReadback();
+    double GetGpuMemoryMib() const;
+    static double GetPeakRssMib();
+
+    const Scenario scenario;
+    const BenchSettings settings;
+
+    uint32_t numRenderedFrames = 0;
+    std::chrono::steady_clock::time_point frameStart;
+    std::chrono::steady_clock::time_point measureStart;
+    std::chrono::steady_clock::time_point measureEnd;
+
+    std::vector<double> cpuFrameMs;
+    std::vector<double> gpuFrameMs;
+    std::vector<double> stepMs; // compile or upload time of the pipelines and uploads scenarios
+
+    Essence::VulkanBuffer uploadTarget;
+    std::vector<std::byte> uploadData;
+    uint32_t numCompiledPipelines = 0;
+
+    Essence::CpuFractalRenderer cpuRenderer;
+    Essence::VulkanBuffer readbackBuffer;
+    std::vector<uint16_t> referencePixels; // CPU image of the frame that is read back
+    uint64_t readbackValue = 0;            // 0 while nothing is read back
+    std::optional<Essence::CpuFractalRenderer::Difference> gpuDifference;
+};
+
+}
\ No newline at end of file
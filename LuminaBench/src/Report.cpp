@@ -0,0 +1,252 @@
+#include "Report.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace Lumina::Bench {
+
+namespace {
+
+double Percentile(std::vector<double> const& sorted, double fraction) {
+    auto index = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size()))) - 1;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Just enough JSON for the reports written below: objects, numbers and strings, no arrays or escapes.
+class FlatJsonReader {
+public:
+    explicit FlatJsonReader(std::string text) : text(std::move(text)) {}
+
+    std::map<std::string, double> Read() {
+        std::map<std::string, double> values;
+        ReadObject("", values);
+        return values;
+    }
+
+private:
+    void ReadObject(std::string const& prefix, std::map<std::string, double>& values) {
+        Expect('{');
+        if (Peek() == '}') {
+            pos++;
+            return;
+        }
+
+        while (true) {
+            std::string key = ReadString();
+            Expect(':');
+
+            std::string path = prefix.empty() ? key : prefix + "." + key;
+            char c = Peek();
+            if (c == '{') {
+                ReadObject(path, values);
+            }
+            else if (c == '"') {
+                ReadString();
+            }
+            else {
+                values[path] = ReadNumber();
+            }
+
+            c = Peek();
+            pos++;
+            if (c == '}') {
+                return;
+            }
+            if (c != ',') {
+                throw std::runtime_error(std::format("Expected ',' or '}}' at offset {}", pos - 1));
+            }
+        }
+    }
+
+    std::string ReadString() {
+        Expect('"');
+        size_t end = text.find('"', pos);
+        if (end == std::string::npos) {
+            throw std::runtime_error("Unterminated string");
+        }
+        std::string value = text.substr(pos, end - pos);
+        pos = end + 1;
+        return value;
+    }
+
+    double ReadNumber() {
+        size_t length = 0;
+        double value = std::stod(text.substr(pos, 32), &length);
+        pos += length;
+        return value;
+    }
+
+    void Expect(char c) {
+        if (Peek() != c) {
+            throw std::runtime_error(std::format("Expected '{}' at offset {}", c, pos));
+        }
+        pos++;
+    }
+
+    char Peek() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+        if (pos >= text.size()) {
+            throw std::runtime_error("Unexpected end of report");
+        }
+        return text[pos];
+    }
+
+    std::string text;
+    size_t pos = 0;
+};
+
+}
+
+Distribution Distribution::FromSamples(std::vector<double> samples) {
+    Distribution distribution;
+    if (samples.empty()) {
+        return distribution;
+    }
+
+    std::ranges::sort(samples);
+
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+
+    distribution.avg = sum / static_cast<double>(samples.size());
+    distribution.p50 = Percentile(samples, 0.50);
+    distribution.p95 = Percentile(samples, 0.95);
+    distribution.p99 = Percentile(samples, 0.99);
+    distribution.max = samples.back();
+    distribution.numSamples = static_cast<uint32_t>(samples.size());
+    return distribution;
+}
+
+void WriteReport(std::filesystem::path const& path, std::vector<ScenarioResult> const& results) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Failed to open file \"{}\"!", path.string()));
+    }
+
+    file << "{\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        auto const& result = results[i];
+        file << std::format("  \"{}\": {{\n", result.name);
+        file << std::format("    \"frames\": {},\n", result.numFrames);
+        file << std::format("    \"duration_s\": {}", result.durationSeconds);
+
+        for (auto const& [name, distribution] : result.distributions) {
+            file << std::format(
+                ",\n    \"{}\": {{\"avg\": {}, \"p50\": {}, \"p95\": {}, \"p99\": {}, \"max\": {}, \"samples\": {}}}",
+                name,
+                distribution.avg,
+                distribution.p50,
+                distribution.p95,
+                distribution.p99,
+                distribution.max,
+                distribution.numSamples
+            );
+        }
+
+        if (!result.startupMs.empty()) {
+            file << ",\n    \"startup_ms\": {";
+            for (size_t j = 0; j < result.startupMs.size(); j++) {
+                file << std::format("{}\"{}\": {}", j == 0 ? "" : ", ", result.startupMs[j].first, result.startupMs[j].second);
+            }
+            file << "}";
+        }
+
+        for (auto const& [name, value] : result.values) {
+            file << std::format(",\n    \"{}\": {}", name, value);
+        }
+
+        file << std::format("\n  }}{}\n", i + 1 < results.size() ? "," : "");
+    }
+    file << "}\n";
+
+    // a full disk only shows up once the buffer is written out
+    file.flush();
+    if (!file.good()) {
+        throw std::runtime_error(std::format("Failed to write file \"{}\"!", path.string()));
+    }
+}
+
+std::map<std::string, double> ReadReport(std::filesystem::path const& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Failed to open file \"{}\"!", path.string()));
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    try {
+        return FlatJsonReader(buffer.str()).Read();
+    }
+    catch (std::exception const& e) {
+        throw std::runtime_error(std::format("Failed to parse \"{}\": {}", path.string(), e.what()));
+    }
+}
+
+std::map<std::string, double> FlattenReport(std::vector<ScenarioResult> const& results) {
+    std::map<std::string, double> values;
+    for (auto const& result : results) {
+        std::string const& prefix = result.name;
+        values[prefix + ".frames"] = result.numFrames;
+        values[prefix + ".duration_s"] = result.durationSeconds;
+        for (auto const& [name, distribution] : result.distributions) {
+            values[std::format("{}.{}.avg", prefix, name)] = distribution.avg;
+            values[std::format("{}.{}.p50", prefix, name)] = distribution.p50;
+            values[std::format("{}.{}.p95", prefix, name)] = distribution.p95;
+            values[std::format("{}.{}.p99", prefix, name)] = distribution.p99;
+            values[std::format("{}.{}.max", prefix, name)] = distribution.max;
+            values[std::format("{}.{}.samples", prefix, name)] = distribution.numSamples;
+        }
+        for (auto const& [name, value] : result.startupMs) {
+            values[std::format("{}.startup_ms.{}", prefix, name)] = value;
+        }
+        for (auto const& [name, value] : result.values) {
+            values[std::format("{}.{}", prefix, name)] = value;
+        }
+    }
+    return values;
+}
+
+std::vector<Regression> FindRegressions(
+    std::map<std::string, double> const& baseline, std::map<std::string, double> const& current, Thresholds const& thresholds
+) {
+    std::vector<Regression> regressions;
+    for (auto const& [metric, baselineValue] : baseline) {
+        auto it = current.find(metric);
+        // sample counts and run lengths describe the run, they aren't results
+        if (it == current.end() || metric.ends_with(".frames") || metric.ends_with(".duration_s") || metric.ends_with(".samples")) {
+            continue;
+        }
+        double currentValue = it->second;
+
+        bool isMemory = metric.ends_with("_mib");
+        bool isHigherBetter = metric.ends_with("_per_s");
+        double threshold = isMemory ? thresholds.memory : thresholds.time;
+
+        bool hasRegressed;
+        if (isHigherBetter) {
+            hasRegressed = currentValue < baselineValue * (1 - threshold);
+        }
+        else {
+            hasRegressed = currentValue > baselineValue * (1 + threshold);
+            if (!isMemory && currentValue - baselineValue < thresholds.minTimeDeltaMs) {
+                hasRegressed = false;
+            }
+        }
+
+        if (hasRegressed) {
+            regressions.push_back({metric, baselineValue, currentValue});
+        }
+    }
+    return regressions;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Lumina::Bench {
+
+struct Distribution {
+    double avg = 0;
+    double p50 = 0;
+    double p95 = 0;
+    double p99 = 0;
+    double max = 0;
+    uint32_t numSamples = 0;
+
+    static Distribution FromSamples(std::vector<double> samples);
+};
+
+struct ScenarioResult {
+    std::string name;
+    uint32_t numFrames = 0;
+    double durationSeconds = 0;
+
+    std::vector<std::pair<std::string, Distribution>> distributions; // e.g. cpu_frame_ms
+    std::vector<std::pair<std::string, double>> startupMs;           // per Application::Initialize() phase
+    std::vector<std::pair<std::string, double>> values;              // e.g. peak_rss_mib
+};
+
+void WriteReport(std::filesystem::path const& path, std::vector<ScenarioResult> const& results);
+
+// Every number of a report keyed by its path, e.g. "julia.cpu_frame_ms.p95".
+std::map<std::string, double> ReadReport(std::filesystem::path const& path);
+std::map<std::string, double> FlattenReport(std::vector<ScenarioResult> const& results);
+
+struct Thresholds {
+    double time = 0.1;   // relative, for everything that isn't memory
+    double memory = 0.1; // relative, for metrics ending in _mib
+    double minTimeDeltaMs = 0.05; // differences below this are noise, whatever the ratio
+};
+
+struct Regression {
+    std::string metric;
+    double baseline;
+    double current;
+};
+
+// Metrics ending in _per_s are better when higher, everything else is better when lower. Metrics missing
+// from either side are skipped, so scenarios can be added without invalidating old baselines.
+std::vector<Regression> FindRegressions(
+    std::map<std::string, double> const& baseline, std::map<std::string, double> const& current, Thresholds const& thresholds
+);
+
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BenchApplication.hpp"
+#include "Report.hpp"
+
+#include "Lumina/Essence/Log.hpp"
+
+using namespace Lumina;
+
+namespace {
+
+void PrintUsage(char const* program) {
+    LUMINA_LOG_INFO(
+        General,
+        "Usage: {} [--scenario=julia,julia-batched,triangle,full,pipelines,uploads,cpu|all] [--frames=N] [--seconds=S] [--warmup=N] "
+        "[--output=report.json] [--baseline=baseline.json] [--threshold=0.1] [--memory-threshold=0.1] [--windowed]",
+        program
+    );
+}
+
+std::vector<Bench::Scenario> ParseScenarios(std::string_view list) {
+    if (list == "all") {
+        return {
+            Bench::Scenario::Julia,
+            Bench::Scenario::JuliaBatched,
+            Bench::Scenario::Triangle,
+            Bench::Scenario::Full,
+            Bench::Scenario::Pipelines,
+            Bench::Scenario::Uploads,
+            Bench::Scenario::Cpu,
+        };
+    }
+
+    std::vector<Bench::Scenario> scenarios;
+    while (!list.empty()) {
+        size_t end = std::min(list.find(','), list.size());
+        auto scenario = Bench::ParseScenario(list.substr(0, end));
+        if (!scenario.has_value()) {
+            throw std::invalid_argument(std::format("Unknown scenario \"{}\"", list.substr(0, end)));
+        }
+        scenarios.push_back(scenario.value());
+        list.remove_prefix(std::min(end + 1, list.size()));
+    }
+    return scenarios;
+}
+
+}
+
+// Renders each scenario for a fixed number of frames or seconds, writes the results as json and fails with
+// exit code 1 if a baseline is given and any metric regressed by more than the threshold. Invalid arguments, a
+// scenario that fails to initialize or run, or a report that can't be written or read fail with exit code 2.
+int main(int argc, char** argv) {
+    std::vector<Bench::Scenario> scenarios = ParseScenarios("all");
+    Bench::BenchSettings settings;
+    Bench::Thresholds thresholds;
+    std::string outputPath = "bench_report.json";
+    std::string baselinePath;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string_view arg = argv[i];
+            std::string value(arg.substr(std::min(arg.find('='), arg.size() - 1) + 1));
+
+            if (arg.starts_with("--scenario=")) {
+                scenarios = ParseScenarios(value);
+            }
+            else if (arg.starts_with("--frames=")) {
+                settings.numFrames = std::stoul(value);
+            }
+            else if (arg.starts_with("--seconds=")) {
+                // the frame limit still applies, so a time limit alone has to lift it
+                settings.maxSeconds = std::stod(value);
+                settings.numFrames = std::numeric_limits<uint32_t>::max();
+            }
+            else if (arg.starts_with("--warmup=")) {
+                settings.numWarmupFrames = std::stoul(value);
+            }
+            else if (arg.starts_with("--output=")) {
+                outputPath = value;
+            }
+            else if (arg.starts_with("--baseline=")) {
+                baselinePath = value;
+            }
+            else if (arg.starts_with("--threshold=")) {
+                thresholds.time = std::stod(value);
+            }
+            else if (arg.starts_with("--memory-threshold=")) {
+                thresholds.memory = std::stod(value);
+            }
+            else if (arg == "--windowed") {
+                settings.displayMode = Essence::DisplayMode::Windowed;
+            }
+            else {
+                PrintUsage(argv[0]);
+                return 2;
+            }
+        }
+    }
+    catch (std::exception const& e) {
+        LUMINA_LOG_ERROR(General, "Invalid arguments: {}", e.what());
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    std::vector<Bench::ScenarioResult> results;
+    for (Bench::Scenario scenario : scenarios) {
+        // one application per scenario, so startup and memory are measured from scratch every time
+        try {
+            Bench::BenchApplication app(scenario, settings);
+            app.Initialize();
+            app.Run();
+            results.push_back(app.GetResult());
+        }
+        catch (std::exception const& e) {
+            LUMINA_LOG_ERROR(General, "Scenario {} failed: {}", Bench::ToString(scenario), e.what());
+            return 2;
+        }
+
+        auto const& cpuFrameMs = results.back().distributions.front().second;
+        LUMINA_LOG_INFO(
+            General,
+            "{}: {} frames, cpu avg {:.3f} ms, p99 {:.3f} ms",
+            results.back().name,
+            results.back().numFrames,
+            cpuFrameMs.avg,
+            cpuFrameMs.p99
+        );
+    }
+
+    try {
+        Bench::WriteReport(outputPath, results);
+    }
+    catch (std::exception const& e) {
+        LUMINA_LOG_ERROR(General, "Failed to write the report: {}", e.what());
+        return 2;
+    }
+    LUMINA_LOG_INFO(General, "Wrote {}", outputPath);
+
+    if (baselinePath.empty()) {
+        return 0;
+    }
+
+    std::vector<Bench::Regression> regressions;
+    try {
+        regressions = Bench::FindRegressions(Bench::ReadReport(baselinePath), Bench::FlattenReport(results), thresholds);
+    }
+    catch (std::exception const& e) {
+        LUMINA_LOG_ERROR(General, "Failed to read the baseline: {}", e.what());
+        return 2;
+    }
+    for (auto const& regression : regressions) {
+        LUMINA_LOG_ERROR(
+            General,
+            "Regression in {}: {:.3f} -> {:.3f} ({:+.1f}%)",
+            regression.metric,
+            regression.baseline,
+            regression.current,
+            (regression.current / regression.baseline - 1) * 100
+        );
+    }
+    if (!regressions.empty()) {
+        return 1;
+    }
+
+    LUMINA_LOG_INFO(General, "No regressions against {}", baselinePath);
+    return 0;
+}
\ No newline at end of file
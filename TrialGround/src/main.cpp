@@ -1,23 +1,47 @@
-#include <iostream>
+#include <string>
+#include <string_view>
 
 #include "Lumina/Essence/Application.hpp"
+#include "Lumina/Essence/Log.hpp"
 
 using namespace Lumina;
 
 class TrialGroundApplication : public Essence::Application {
 public:
-    TrialGroundApplication(): Application({1920, 1080}, "Trial Ground") {}
+    TrialGroundApplication(Essence::DisplayMode displayMode, uint32_t framesInFlight, double tickRate)
+        : Application({1920, 1080}, "Trial Ground", displayMode) {
+        this->framesInFlight = framesInFlight;
+        // 0 ticks once per frame
+        this->isTickThreadEnabled = tickRate > 0;
+        this->tickRate = tickRate;
+    }
 
     void Initialize() override {
         Application::Initialize();
-        std::cout << "Hello, World!\n";
+        LUMINA_LOG_INFO(General, "Hello, World!");
     }
 
 private:
 };
 
-int main() {
-    TrialGroundApplication app;
+int main(int argc, char** argv) {
+    Essence::DisplayMode displayMode = Essence::DisplayMode::Windowed;
+    uint32_t framesInFlight = 2;
+    double tickRate = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--headless") {
+            displayMode = Essence::DisplayMode::Headless;
+        }
+        else if (arg.starts_with("--frames-in-flight=")) {
+            framesInFlight = std::stoul(std::string(arg.substr(arg.find('=') + 1)));
+        }
+        else if (arg.starts_with("--tick-rate=")) {
+            tickRate = std::stod(std::string(arg.substr(arg.find('=') + 1)));
+        }
+    }
+
+    TrialGroundApplication app(displayMode, framesInFlight, tickRate);
     app.Initialize();
     app.Run();
 